@@ -20,14 +20,67 @@
 #include "ad_queue.h"
 
 // More node info for Burns's algorithm.
+template< class num_t >
 struct ninfo_burns {
-    float dist;    // node distance or potential.
-    int   length;  // path length from source in topological order.
-    int   indeg;   // indegree.
+    typename num_t::dist_t  dist;    // node distance or potential.
+    typename num_t::total_t length;  // path length from source in topological order.
+    int                     indeg;   // indegree.
 };
 
+// Return a critical inedge of node v from a node that the topological
+// sort did not reach, i.e., a node with a positive indeg left, or -1 if
+// there is none.
+template< class num_t >
+static
+int
+critical_inedge( const ad_scc_view *g, const ninfo_burns< num_t > *more_ninfo,
+                 const bool *critical, int v )
+{
+    for ( int i = 0; i < g->indegree( v ); ++i ) {
+        int e = g->ith_source_edge( v, i );
+        if ( critical[ e ] && ( 0 < more_ninfo[ g->source( e ) ].indeg ) )
+            return e;
+    }
+    return -1;
+}  // critical_inedge
+
+// Find a cycle of the critical edges into cycle. Every node that the
+// topological sort did not reach has a critical inedge from another
+// such node, so going backwards from such a node over these inedges
+// ends in a cycle.
+template< class num_t >
+static
+void
+find_critical_cycle( const ad_scc_view *g, const ninfo_burns< num_t > *more_ninfo,
+                     const bool *critical, ad_cycle *cycle )
+{
+    int n = g->num_nodes();
+
+    cycle->reset( n );
+
+    int u = 0;
+    while ( ( u < n ) && ( 0 == more_ninfo[ u ].indeg ) )
+        ++u;
+
+    // After n steps backwards, u must be on a cycle.
+    for ( int i = 0; ( u < n ) && ( i < n ); ++i )
+        u = g->source( critical_inedge( g, more_ninfo, critical, u ) );
+    if ( u == n )
+        return;
+
+    int x = u;
+    do {
+        int e = critical_inedge( g, more_ninfo, critical, x );
+        cycle->add( e );
+        x = g->source( e );
+    } while ( x != u );
+
+    cycle->reverse();
+}  // find_critical_cycle
+
 #if 0
-bool search( const ad_graph< ninfo > *g, int u, bool *visited, bool *critical )
+static
+bool search( const ad_scc_view *g, int u, bool *visited, bool *critical )
 {
     visited[ u ] = true;
     for ( int i = 0; i < g->outdegree( u ); ++i ) {
@@ -44,121 +97,134 @@ bool search( const ad_graph< ninfo > *g, int u, bool *visited, bool *critical )
 }
 #endif
 
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
 {
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
     int n = g->num_nodes();
     int m = g->num_edges();
 
     // critical[e] is true if edge e is critical.
 
-    ninfo_burns      *more_ninfo = new ninfo_burns[ n ];
-    bool             *critical = new bool[ m ];
-    ad_queue< int >  nodeq( n );
-
-    float f_plus_infinity = ( float ) plus_infinity;
-    float f_minus_infinity = -f_plus_infinity;
-
-#ifdef CYCLE_MEAN_VERSION
-    // STEP: Initialize lambda to the minimum of the min edge weight and
-    // the previous lambda:
-    float lambda = lambda_so_far;
-    for ( int e = 0; e < m; ++e )
-        min2( lambda, ( float ) g->edge_info( e ) );
-
-    // STEP: Initialize the distance of each node to zero:
-    for ( int v = 0; v < n; ++v )
-        more_ninfo[ v ].dist = 0.0;
-
-#else
-    // STEP: Initialize node distances and lambda. critical array is
-    // used here to differentiate between the edges with zero or
-    // positive transit times.
-    {
-        // Temporarily remove all edges with positive transit time from
-        // g. The remaining edges can have zero or negative transit times
-        // but for our testcases, the transit time is never negative.
-        for ( int e = 0; e < m; ++e ) {
-            if ( 0 >= g->edge_info2( e ) )
-                critical[ e ] = true;
-            else
-                critical[ e ] = false;
-        }
+    ninfo_burns< num_t > *more_ninfo = new ninfo_burns< num_t >[ n ];
+    bool                 *critical = new bool[ m ];
+    ad_queue< int >      nodeq( n );
 
-        // Topologically sort the resulting graph. Note that if the
-        // resulting graph is cyclic, there are cycles with zero transit
-        // time and this is an error. Using the topological order, set
-        // d(v) of node v to the min distance from the source.
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
+    dist_t f_minus_infinity = -f_plus_infinity;
 
-        // Find the indegree and distance of each node and put them into
-        // the nodeq.
-        nodeq.init();
+    if ( si.cycle )
+        si.cycle->reset( n );
 
-        for ( int v = 0; v < n; ++v ) {
-            more_ninfo[ v ].indeg = 0;
+    dist_t lambda = lambda_so_far;
 
-            for ( int i = 0; i < g->indegree( v ); ++i ) {
-                if ( critical[ g->ith_source_edge( v, i ) ] )
-                    more_ninfo[ v ].indeg++;
-            }
+    if ( num_t::unit_ttime ) {
+        // STEP: Initialize lambda to the minimum of the min edge weight
+        // and the previous lambda:
+        for ( int e = 0; e < m; ++e )
+            min2( lambda, ( dist_t ) g->edge_info( e ) );
 
-            if ( 0 == more_ninfo[ v ].indeg ) {
-                more_ninfo[ v ].dist = 0.0;
-                nodeq.put( v );
-            } else {
-                more_ninfo[ v ].dist = f_plus_infinity;
+        // STEP: Initialize the distance of each node to zero:
+        for ( int v = 0; v < n; ++v )
+            more_ninfo[ v ].dist = 0.0;
+
+    } else {
+        // STEP: Initialize node distances and lambda. critical array is
+        // used here to differentiate between the edges with zero or
+        // positive transit times.
+        {
+            // Temporarily remove all edges with positive transit time from
+            // g. The remaining edges can have zero or negative transit times
+            // but for our testcases, the transit time is never negative.
+            for ( int e = 0; e < m; ++e ) {
+                if ( 0 >= g->edge_info2( e ) )
+                    critical[ e ] = true;
+                else
+                    critical[ e ] = false;
             }
-        }  // for
 
-        // Do the actual topological sorting using the previously found
-        // indegrees and distances for nodes:
+            // Topologically sort the resulting graph. Note that if the
+            // resulting graph is cyclic, there are cycles with zero transit
+            // time and this is an error. Using the topological order, set
+            // d(v) of node v to the min distance from the source.
 
-        int count_visited = 0;  // Number of visited nodes.
-        while ( nodeq.is_not_empty() ) {
-            ++count_visited;
+            // Find the indegree and distance of each node and put them into
+            // the nodeq.
+            nodeq.init();
 
-            int u = nodeq.get();
-            for ( int i = 0; i < g->outdegree( u ); ++i ) {
-                if ( critical[ g->ith_target_edge( u, i ) ] ) {
-                    // edge = u->v
-                    int v = g->ith_target_node( u, i );
+            for ( int v = 0; v < n; ++v ) {
+                more_ninfo[ v ].indeg = 0;
 
-                    // dist[ v ] = min( dist[ v ], dist[ u ] + w(u,v))
-                    min2( more_ninfo[ v ].dist, 
-                          more_ninfo[ u ].dist + g->ith_target_edge_info( u, i ) );
-                    more_ninfo[ v ].indeg--;
+                for ( int i = 0; i < g->indegree( v ); ++i ) {
+                    if ( critical[ g->ith_source_edge( v, i ) ] )
+                        more_ninfo[ v ].indeg++;
+                }
 
-                    if ( 0 == more_ninfo[ v ].indeg )
-                        nodeq.put( v );
+                if ( 0 == more_ninfo[ v ].indeg ) {
+                    more_ninfo[ v ].dist = 0.0;
+                    nodeq.put( v );
+                } else {
+                    more_ninfo[ v ].dist = f_plus_infinity;
                 }
-            }
-        }  // while
+            }  // for
 
-        // The graph of zero transit time edges must not have a cycle. A
-        // cycle shows a deadlock in the systems that this graph models.
-        if ( count_visited != n ) {
-            printf("ERROR: Cycles with zero transit time are not allowed.\n");
-            abort();
+            // Do the actual topological sorting using the previously found
+            // indegrees and distances for nodes:
+
+            int count_visited = 0;  // Number of visited nodes.
+            while ( nodeq.is_not_empty() ) {
+                ++count_visited;
+
+                int u = nodeq.get();
+                for ( int i = 0; i < g->outdegree( u ); ++i ) {
+                    if ( critical[ g->ith_target_edge( u, i ) ] ) {
+                        // edge = u->v
+                        int v = g->ith_target_node( u, i );
+
+                        // dist[ v ] = min( dist[ v ], dist[ u ] + w(u,v))
+                        min2( more_ninfo[ v ].dist, 
+                              more_ninfo[ u ].dist + g->ith_target_edge_info( u, i ) );
+                        more_ninfo[ v ].indeg--;
+
+                        if ( 0 == more_ninfo[ v ].indeg )
+                            nodeq.put( v );
+                    }
+                }
+            }  // while
+
+            // The graph of zero transit time edges must not have a cycle. A
+            // cycle shows a deadlock in the systems that this graph models.
+            if ( count_visited != n ) {
+                printf("ERROR: Cycles with zero transit time are not allowed.\n");
+                abort();
+            }
         }
-    }
 
-    // Set lambda to the minimum of ((d(v)+w(u,v)-d(u)) / tt(u,v)) if t(u,v) > 0.
-    float lambda = lambda_so_far;
-    for ( int e = 0; e < m; ++e ) {
-        int u = g->source( e );
-        int v = g->target( e );
-        if ( 0 < g->edge_info2( e ) ) {
-            float delta = more_ninfo[ u ].dist + g->edge_info( e ) - more_ninfo[ v ].dist;
-            min2( lambda, delta / g->edge_info2( e ) );
+        // Set lambda to the minimum of ((d(v)+w(u,v)-d(u)) / tt(u,v)) if t(u,v) > 0.
+        for ( int e = 0; e < m; ++e ) {
+            int u = g->source( e );
+            int v = g->target( e );
+            if ( 0 < g->edge_info2( e ) ) {
+                dist_t delta = more_ninfo[ u ].dist + g->edge_info( e ) - more_ninfo[ v ].dist;
+                min2( lambda, delta / g->edge_info2( e ) );
+            }
         }
     }
-#endif
 
     // STEP: Iterate until the critical graph is cyclic.
     while ( true ) {
 
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            break;
+
 #ifdef PROGRESS
         printf( "PROGRESS Iteration number= %d lambda= %10.2f\n", NITER, lambda );
 #endif
@@ -173,22 +239,13 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             int u = g->source( e );
             int v = g->target( e );
 
-            float delta1 = more_ninfo[ u ].dist + g->edge_info( e ) - more_ninfo[ v ].dist;
-#ifdef CYCLE_MEAN_VERSION
-            if ( fabs_val( lambda - delta1 ) < SMALL_EPSILON ) {
-                critical[ e ] = true;
-                ++ncrit;
-            } else {
-                critical[ e ] = false;
-            }
-#else 
-            if ( fabs_val( lambda * g->edge_info2( e ) - delta1 ) < SMALL_EPSILON ) {
+            dist_t delta1 = more_ninfo[ u ].dist + g->edge_info( e ) - more_ninfo[ v ].dist;
+            if ( fabs_val( lambda * edge_ttime< num_t >( g, e ) - delta1 ) < SMALL_EPSILON ) {
                 critical[ e ] = true;
                 ++ncrit;
             } else {
                 critical[ e ] = false;
             }
-#endif
         }  // for each edge
 
         // STEP: Topologically sort the critical graph:
@@ -226,13 +283,8 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     // edge = u->v
                     int v = g->ith_target_node( u, i );
 
-#ifdef CYCLE_MEAN_VERSION
-                    // length[ v ] = min( length[ v ], length[ u ] - 1 )
-                    min2( more_ninfo[ v ].length, more_ninfo[ u ].length - 1 );
-#else
                     // length[ v ] = min( length[ v ], length[ u ] - t(u,v) )
-                    min2( more_ninfo[ v ].length, more_ninfo[ u ].length - g->ith_target_edge_info2( u, i ) );
-#endif
+                    min2( more_ninfo[ v ].length, more_ninfo[ u ].length - ith_target_edge_ttime< num_t >( g, u, i ) );
 
                     more_ninfo[ v ].indeg--;
 
@@ -243,9 +295,13 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         }  // while
 
         // STEP: If the critical graph is cyclic, then the optimum lambda
-        // is found, so exit.
-        if ( count_visited != n )
+        // is found, so exit. Any cycle of the critical graph is a
+        // critical cycle.
+        if ( count_visited != n ) {
+            if ( si.cycle )
+                find_critical_cycle( g, more_ninfo, critical, si.cycle );
             break;
+        }
 
 #if 0
         /***********************/
@@ -270,25 +326,17 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
         // STEP: Find theta to update lambda as well as the distance of
         // every node:
-        float theta = f_minus_infinity;
+        dist_t theta = f_minus_infinity;
         for ( int e = 0; e < m; ++e ) {
             // e = u->v
             int u = g->source( e );
             int v = g->target( e );
 
-#ifdef CYCLE_MEAN_VERSION
-            int delta2 = more_ninfo[ v ].length + 1 - more_ninfo[ u ].length;
+            total_t delta2 = more_ninfo[ v ].length + edge_ttime< num_t >( g, e ) - more_ninfo[ u ].length;
             if ( delta2 > 0 ) {
-                float delta1 = more_ninfo[ u ].dist + g->edge_info( e ) - more_ninfo[ v ].dist;
-                max2( theta, ( lambda - delta1 ) / delta2 );
+                dist_t delta1 = more_ninfo[ u ].dist + g->edge_info( e ) - more_ninfo[ v ].dist;
+                max2( theta, ( lambda * edge_ttime< num_t >( g, e ) - delta1 ) / delta2 );
             }
-#else
-            int delta2 = more_ninfo[ v ].length + g->edge_info2( e ) - more_ninfo[ u ].length;
-            if ( delta2 > 0 ) {
-                float delta1 = more_ninfo[ u ].dist + g->edge_info( e ) - more_ninfo[ v ].dist;
-                max2( theta, ( lambda * g->edge_info2( e ) - delta1 ) / delta2 );
-            }
-#endif
         }  // for each edge
 
         // STEP: Using theta, update lambda as well as the distance of
@@ -305,4 +353,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     return lambda;
 } // find_min_cycle_ratio_for_scc
 
+// Register the solver, instantiated for each numeric policy.
+const ad_solver burns_solver = { "burns", false,
+                                 AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &burns_solver );
+
 // End of file
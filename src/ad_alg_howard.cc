@@ -8,71 +8,650 @@
 //
 
 // Parameters of interest: NITER, NCYCLES, CYCLELEN, CHECK_LIMIT,
-// NUPDATES, QUEUELEN, NEDGES, not_improved.
+// NUPDATES, NSWITCHES, QUEUELEN, NEDGES, not_improved, policy_stable.
 
 // count[0] = number of iterations to finish
 // count[1] = number of iterations to find final lambda
+// count[2] = number of policy edges changed
 
 #include "ad_graph.h"
+#include "ad_cqueue.h"
 #include "ad_queue.h"
+#include "ad_simd.h"
+#include "ad_thread.h"
 
 #define BELLMAN_FORD_LIKE
 //#define MAKE_POLICY_CONNECTED
+#define POLICY_ITERATION_EXIT
+#define INCREMENTAL_CYCLE_SEARCH
+#define WORKLIST_DIST_UPDATE
 
 // More node info for Howard's algorithm. For a node u,
 // more_ninfo[u].policy = (u, more_ninfo[u].target). Carrying target,
-// einfo (weight of policy edge), and einfo2 (transit time of policy
+// einfo (weight of policy edge), and einfo2() (transit time of policy
 // edge) is redundant but it makes running time faster by eliminating
 // access to the edge list.
-struct ninfo_how {
-    float dist;    // node potential.
-    int   visited; // set if node is visited for some purpose.
-    int   policy;  // successor edge.
-    int   target;  // successor node
-    int   einfo;   // weight of policy edge.
-#ifndef CYCLE_MEAN_VERSION
-    int   einfo2;  // transit time of policy edge.
-#endif
+template< class num_t >
+struct ninfo_how : public ad_ttime_info< num_t > {
+    typename num_t::dist_t   dist;    // node potential.
+    int                      visited; // set if node is visited for some purpose.
+    int                      policy;  // successor edge.
+    int                      target;  // successor node
+    typename num_t::weight_t einfo;   // weight of policy edge.
+    bool                     in_queue; // set if node is in the dirty queue.
 };
 
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+// Put u into dirtyq unless it is in already. Return the number of
+// nodes put.
+template< class num_t >
+static
+int
+put_dirty( ninfo_how< num_t > *more_ninfo, ad_cqueue< int > *dirtyq, int u )
+{
+    if ( more_ninfo[ u ].in_queue )
+        return 0;
+    more_ninfo[ u ].in_queue = true;
+    dirtyq->put( u );
+    return 1;
+}  // put_dirty
+
+// Improve the dist of every node whose policy path leads to root,
+// i.e., of the tree of root in the policy graph, along its policy edge
+// as the dist update of an iteration does, but in the order of a
+// reverse BFS from root, so that an improvement reaches the whole tree
+// at once. The policy edge out of root is not used. Use nodeq for the
+// BFS, and mark the nodes of the tree as visited = mark, which no node
+// may be but those of the trees already done. If dirtyq is not NULL,
+// put each node improved into it, and add the number put to *ndirty.
+// Return the number of dists improved.
+template< class num_t >
+static
+int
+improve_tree_dists( const ad_scc_view *g, ninfo_how< num_t > *more_ninfo,
+                    ad_queue< int > *nodeq, int root, typename num_t::dist_t lambda,
+                    int mark, ad_cqueue< int > *dirtyq, int *ndirty )
+{
+    if ( mark == more_ninfo[ root ].visited )
+        return 0;
+
+    int nimproved = 0;
+    nodeq->init();
+    nodeq->put( root );
+    more_ninfo[ root ].visited = mark;
+
+    while ( nodeq->is_not_empty() ) {
+        int v = nodeq->get();
+        for ( int i = 0; i < g->indegree( v ); ++i ) {
+            int u = g->ith_source_node( v, i );
+            if ( ( mark != more_ninfo[ u ].visited ) && ( v == more_ninfo[ u ].target ) ) {
+                typename num_t::dist_t new_dist = more_ninfo[ v ].dist +
+                    more_ninfo[ u ].einfo - lambda * more_ninfo[ u ].einfo2();
+                if ( EPSILON < ( more_ninfo[ u ].dist - new_dist ) ) {
+                    more_ninfo[ u ].dist = new_dist;
+                    ++nimproved;
+                    if ( dirtyq )
+                        *ndirty += put_dirty( more_ninfo, dirtyq, u );
+                }
+                more_ninfo[ u ].visited = mark;
+                nodeq->put( u );
+            }
+        }
+    }
+
+    return nimproved;
+}  // improve_tree_dists
+
+///////////////////////////////////////////////////////////////////////
+// Parallel version: with si.nthreads threads, or one thread per
+// PHOWARD_MIN_NODES nodes if fewer, both halves of each iteration are
+// split by node. Thread k owns the nodes node_first[ k ], ...,
+// node_first[ k + 1 ] - 1, which have about the same number of
+// outedges for each thread.
+//
+// The cycles of the policy graph are found by walks as in the serial
+// version, but a walk claims each node by a compare-and-swap on
+// visited, and stops at a node claimed by another walk. A cycle that no
+// walk went around is found afterwards from the walks that stopped at
+// each other. Each cycle is named by its smallest node, and the cycle
+// with the smallest mean, or with the smallest name among equal means,
+// is taken. Every node then improves its dist from the dists of the
+// previous iteration rather than the current ones. So neither half
+// depends on how the nodes are split, and the results are the same
+// for any number of threads. They are not those of the serial version,
+// which goes over the cycles and the edges in another order, so this
+// version is taken for any si.nthreads above 0, even if it is 1 or g
+// is too small to split, and the serial one only for 0.
+
+const int PHOWARD_MIN_NODES = 1024;  // Fewest nodes per thread.
+
+// Work shared by the threads of the parallel version.
+template< class num_t >
+struct phoward_work {
+    typedef typename num_t::dist_t dist_t;
+
+    const ad_scc_view  *g;
+    ninfo_how< num_t > *more_ninfo;
+    ad_queue< int >    *nodeq;
+    const sinfo        *si;
+    int                nthreads;
+    int                next_thread;   // Next thread number.
+    int                *node_first;   // First node of each thread.
+    pthread_barrier_t  barrier;
+
+    dist_t             *old_dist;     // Dists of the previous iteration.
+    int                *hit;          // Walk stopped at by the walk from v.
+    int                *hit_node;     // Node stopped at by the walk from v.
+    int                *nlinked;      // Walks of thread k stopped at another walk,
+    int                *linked;       // kept in linked from node_first[ k ] on.
+    dist_t             *cycle_lambda; // Best cycle mean found by each thread.
+    int                *cycle_node;   // Its name, or -1 if none.
+    int                *ncycles;      // Names of the cycles found by thread k,
+    int                *cycles;       // kept in cycles from node_first[ k ] on.
+    bool               *improved;     // True if thread k improved a dist.
+    int                *nswitches;    // Policy edges changed by thread k.
+
+    dist_t             lambda;
+    bool               done;
+    int                CHECK_LIMIT;
+    int                CHECK_COUNT;
+};
+
+// Return the smallest node of the policy graph cycle through u, and set
+// new_lambda to its mean.
+template< class num_t >
+static
+int
+eval_cycle( const ninfo_how< num_t > *more_ninfo, int u, typename num_t::dist_t& new_lambda )
+{
+    typename num_t::total_t total_weight = 0;
+    typename num_t::total_t total_length = 0;
+
+    int w = u;
+    int min_node = u;
+    do {
+        total_length += more_ninfo[ u ].einfo2();
+        total_weight += more_ninfo[ u ].einfo;
+        min2( min_node, u );
+        u = more_ninfo[ u ].target;
+    } while ( u != w );
+
+    new_lambda = ( typename num_t::dist_t ) total_weight / total_length;
+    return min_node;
+}  // eval_cycle
+
+// Keep the cycle named v with mean l in ( best_lambda, best_node ) if it
+// is better, i.e., has a smaller mean, or a smaller name for the same
+// mean.
+template< class dist_t >
+inline
+void
+keep_better_cycle( dist_t l, int v, dist_t& best_lambda, int& best_node )
+{
+    if ( ( -1 == best_node ) || ( l < best_lambda ) ||
+         ( ( l == best_lambda ) && ( v < best_node ) ) ) {
+        best_lambda = l;
+        best_node = v;
+    }
+}  // keep_better_cycle
+
+// Thread 0's part of an iteration, done alone: find the cycles that no
+// walk went around, take the best cycle, and update lambda and the
+// dists as in the serial version.
+template< class num_t >
+static
+void
+phoward_step( phoward_work< num_t > *w )
+{
+    typedef typename num_t::dist_t dist_t;
+
+    const ad_scc_view  *g = w->g;
+    ninfo_how< num_t > *more_ninfo = w->more_ninfo;
+    int                n = g->num_nodes();
+
+#ifdef REP_COUNT
+    count[ 0 ]++;
+#endif
+
+    // Give up if another solver finished first.
+    if ( w->si->stopped() ) {
+        w->done = true;
+        return;
+    }
+
+    dist_t best_lambda = 0;
+    int    best_node = -1;
+    for ( int k = 0; k < w->nthreads; ++k ) {
+        if ( -1 != w->cycle_node[ k ] )
+            keep_better_cycle( w->cycle_lambda[ k ], w->cycle_node[ k ], best_lambda, best_node );
+    }
+
+    // A linked walk stopped at another walk. Following the stops from
+    // each linked walk, marking them in hit, ends at a walk that found
+    // its cycle, at a walk marked before, or at a walk marked by itself,
+    // in which case the stops went around a cycle, and the node that the
+    // last walk stopped at is on it. The names of these cycles replace
+    // the linked walks read so far in linked.
+    for ( int k = 0; k < w->nthreads; ++k ) {
+        int *linked = &w->linked[ w->node_first[ k ] ];
+        int nfound = 0;
+        for ( int j = 0; j < w->nlinked[ k ]; ++j ) {
+            int v = linked[ j ];
+            int x = v;
+            while ( 0 <= w->hit[ x ] ) {
+                int y = w->hit[ x ];
+                w->hit[ x ] = -3 - v;
+                x = y;
+            }
+            if ( w->hit[ x ] == -3 - v ) {
+                dist_t new_lambda;
+                int    u = eval_cycle( more_ninfo, w->hit_node[ x ], new_lambda );
+                keep_better_cycle( new_lambda, u, best_lambda, best_node );
+                linked[ nfound++ ] = u;
+            }
+        }
+        w->nlinked[ k ] = nfound;
+    }
+
+    if ( ( -1 == best_node ) || !( best_lambda < w->lambda ) ) {
+        if ( w->CHECK_COUNT++ > w->CHECK_LIMIT ) {
+#ifdef PROGRESS
+            printf( "COUNTERS reason to exit: CHECK_LIMIT\n" );
+#endif
+            w->done = true;
+        }
+        return;
+    }
+
+    w->CHECK_COUNT = 0;
+    w->lambda = best_lambda;
+
+    if ( w->si->cycle ) {
+        w->si->cycle->reset( n );
+        int u = best_node;
+        do {
+            w->si->cycle->add( more_ninfo[ u ].policy );
+            u = more_ninfo[ u ].target;
+        } while ( u != best_node );
+    }
+
+#ifdef REP_COUNT
+    count[ 1 ] = count[ 0 ];
+#endif
+
+    // Update the dist of every predecessor node of best_node in the
+    // policy graph by a reverse BFS. visited is not -1 for any node at
+    // this point, and -1 marks the visited nodes below.
+    ad_queue< int > *nodeq = w->nodeq;
+    nodeq->init();
+    nodeq->put( best_node );
+    more_ninfo[ best_node ].visited = -1;
+
+    while ( nodeq->is_not_empty() ) {
+        int v = nodeq->get();
+        for ( int i = 0; i < g->indegree( v ); ++i ) {
+            int u = g->ith_source_node( v, i );
+            if ( ( -1 != more_ninfo[ u ].visited ) && ( v == more_ninfo[ u ].target ) ) {
+                more_ninfo[ u ].visited = -1;
+                more_ninfo[ u ].dist = more_ninfo[ v ].dist +
+                    more_ninfo[ u ].einfo - w->lambda * more_ninfo[ u ].einfo2();
+                nodeq->put( u );
+            }
+        }
+    }
+}  // phoward_step
+
+// Let the dists catch up along each tree of the policy graph as in the
+// serial version, done alone by thread 0 after phoward_step(). The
+// trees do not share nodes, and each is improved from the name of its
+// cycle, so the result does not depend on which thread found it.
+template< class num_t >
+static
+void
+phoward_catch_up( phoward_work< num_t > *w )
+{
+    for ( int k = 0; k < w->nthreads; ++k ) {
+        for ( int j = 0; j < w->ncycles[ k ]; ++j )
+            improve_tree_dists( w->g, w->more_ninfo, w->nodeq, w->cycles[ w->node_first[ k ] + j ], w->lambda, -1, NULL, NULL );
+        for ( int j = 0; j < w->nlinked[ k ]; ++j )
+            improve_tree_dists( w->g, w->more_ninfo, w->nodeq, w->linked[ w->node_first[ k ] + j ], w->lambda, -1, NULL, NULL );
+    }
+}  // phoward_catch_up
+
+template< class num_t >
+static
+void *
+phoward_thread( void *arg )
+{
+    typedef typename num_t::dist_t dist_t;
+
+    phoward_work< num_t > *w = ( phoward_work< num_t > * ) arg;
+    const ad_scc_view     *g = w->g;
+    ninfo_how< num_t >    *more_ninfo = w->more_ninfo;
+
+    int k = __atomic_fetch_add( &w->next_thread, 1, __ATOMIC_RELAXED );
+    int first = w->node_first[ k ];
+    int last = w->node_first[ k + 1 ];
+
+    for ( int v = first; v < last; ++v )
+        more_ninfo[ v ].visited = -1;
+    pthread_barrier_wait( &w->barrier );
+
+    bool catch_up = false;  // As in the serial version.
+
+    while ( true ) {
+
+        // STEP: Walk the policy graph from the nodes of this thread. A
+        // walk from v claims the nodes by setting their visited to v,
+        // and stops at a node claimed before, by itself if it went
+        // around a cycle. v is not a walk if it was claimed before.
+        w->nlinked[ k ] = 0;
+        w->ncycles[ k ] = 0;
+        w->cycle_node[ k ] = -1;
+        for ( int v = first; v < last; ++v ) {
+            w->hit[ v ] = -2;
+
+            int u = v;
+            int owner = -1;
+            while ( __atomic_compare_exchange_n( &more_ninfo[ u ].visited, &owner, v, false,
+                                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+                u = more_ninfo[ u ].target;
+
+            if ( owner == v ) {
+                w->hit[ v ] = -1;
+                dist_t new_lambda;
+                int    x = eval_cycle( more_ninfo, u, new_lambda );
+                keep_better_cycle( new_lambda, x, w->cycle_lambda[ k ], w->cycle_node[ k ] );
+                w->cycles[ first + w->ncycles[ k ]++ ] = x;
+            } else if ( u != v ) {
+                w->hit[ v ] = owner;
+                w->hit_node[ v ] = u;
+                w->linked[ first + w->nlinked[ k ]++ ] = v;
+            }
+        }
+        pthread_barrier_wait( &w->barrier );
+
+        if ( 0 == k ) {
+            phoward_step( w );
+            if ( catch_up && !w->done )
+                phoward_catch_up( w );
+        }
+        pthread_barrier_wait( &w->barrier );
+
+        if ( w->done )
+            break;
+
+        // STEP: Improve the dists of the nodes of this thread from the
+        // dists of the previous iteration, and make the nodes unvisited
+        // for the next iteration.
+        for ( int v = first; v < last; ++v )
+            w->old_dist[ v ] = more_ninfo[ v ].dist;
+        pthread_barrier_wait( &w->barrier );
+
+        dist_t lambda = w->lambda;
+        bool   improved = false;
+        int    nswitches = 0;
+        for ( int u = first; u < last; ++u ) {
+            dist_t d = w->old_dist[ u ];
+            int which = -1;
+            for ( int i = 0; i < g->outdegree( u ); ++i ) {
+                dist_t new_dist = w->old_dist[ g->ith_target_node( u, i ) ] +
+                    g->ith_target_edge_info( u, i ) - lambda * ith_target_edge_ttime< num_t >( g, u, i );
+                if ( EPSILON < ( d - new_dist ) ) {
+                    d = new_dist;
+                    which = i;
+                }
+            }
+            if ( -1 != which ) {
+                improved = true;
+                if ( g->ith_target_edge( u, which ) != more_ninfo[ u ].policy )
+                    ++nswitches;
+                more_ninfo[ u ].dist = d;
+                more_ninfo[ u ].policy = g->ith_target_edge( u, which );
+                more_ninfo[ u ].target = g->ith_target_node( u, which );
+                more_ninfo[ u ].einfo = g->ith_target_edge_info( u, which );
+                more_ninfo[ u ].set_einfo2( ith_target_edge_ttime< num_t >( g, u, which ) );
+            }
+            more_ninfo[ u ].visited = -1;
+        }
+        w->improved[ k ] = improved;
+        w->nswitches[ k ] = nswitches;
+        pthread_barrier_wait( &w->barrier );
+
+        bool not_improved = true;
+        nswitches = 0;
+        for ( int j = 0; j < w->nthreads; ++j ) {
+            if ( w->improved[ j ] )
+                not_improved = false;
+            nswitches += w->nswitches[ j ];
+        }
+
+        if ( 0 == k ) {
+#ifdef PROGRESS
+            printf( "COUNTERS NSWITCHES= %d\n", nswitches );
+#endif
+#ifdef REP_COUNT
+            count[ 2 ] += nswitches;
+#endif
+        }
+
+#ifdef POLICY_ITERATION_EXIT
+        if ( 0 == nswitches ) {
+            if ( catch_up ) {
+#ifdef PROGRESS
+                if ( 0 == k )
+                    printf( "COUNTERS reason to exit: policy_stable\n" );
+#endif
+                break;
+            }
+            catch_up = true;
+        } else {
+            catch_up = false;
+        }
+#endif
+
+        if ( not_improved ) {
+#ifdef PROGRESS
+            if ( 0 == k )
+                printf( "COUNTERS reason to exit: not_improved\n" );
+#endif
+            break;
+        }
+    }  // main while loop
+
+    return NULL;
+}  // phoward_thread
+
+// Do the iterations of Howard's algorithm on g from the policy graph in
+// more_ninfo with nthreads threads, and return lambda.
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_parallel( const ad_scc_view *g, ninfo_how< num_t > *more_ninfo,
+                               ad_queue< int > *nodeq, typename num_t::dist_t lambda,
+                               int nthreads, const sinfo& si )
 {
+    typedef typename num_t::dist_t dist_t;
+
     int n = g->num_nodes();
     int m = g->num_edges();
 
-    ninfo_how        *more_ninfo = new ninfo_how[ n ];
-    ad_queue< int >  nodeq( n );
+    phoward_work< num_t > w;
+    w.g = g;
+    w.more_ninfo = more_ninfo;
+    w.nodeq = nodeq;
+    w.si = &si;
+    w.nthreads = nthreads;
+    w.next_thread = 0;
+    w.node_first = new int[ nthreads + 1 ];
+    w.old_dist = new dist_t[ n ];
+    w.hit = new int[ n ];
+    w.hit_node = new int[ n ];
+    w.nlinked = new int[ nthreads ];
+    w.linked = new int[ n ];
+    w.cycle_lambda = new dist_t[ nthreads ];
+    w.cycle_node = new int[ nthreads ];
+    w.ncycles = new int[ nthreads ];
+    w.cycles = new int[ n ];
+    w.improved = new bool[ nthreads ];
+    w.nswitches = new int[ nthreads ];
+    w.lambda = lambda;
+    w.done = false;
+    w.CHECK_LIMIT = n;
+    w.CHECK_COUNT = 0;
+
+    // Split the nodes so that each thread has about the same number of
+    // nodes plus outedges.
+    long long total = ( long long ) n + m;
+    long long sum = 0;
+    int       v = 0;
+    w.node_first[ 0 ] = 0;
+    for ( int k = 1; k < nthreads; ++k ) {
+        while ( ( v < n ) && ( sum < total * k / nthreads ) ) {
+            sum += 1 + g->outdegree( v );
+            ++v;
+        }
+        w.node_first[ k ] = v;
+    }
+    w.node_first[ nthreads ] = n;
 
-    float f_plus_infinity = ( float ) plus_infinity;
+    pthread_barrier_init( &w.barrier, NULL, nthreads );
+    run_threads( nthreads, phoward_thread< num_t >, &w );
+    pthread_barrier_destroy( &w.barrier );
 
-    // STEP: Find the initial policy graph:
-    for ( int v = 0; v < n; ++v )
-        more_ninfo[ v ].dist = f_plus_infinity;
+    delete [] w.node_first;
+    delete [] w.old_dist;
+    delete [] w.hit;
+    delete [] w.hit_node;
+    delete [] w.nlinked;
+    delete [] w.linked;
+    delete [] w.cycle_lambda;
+    delete [] w.cycle_node;
+    delete [] w.ncycles;
+    delete [] w.cycles;
+    delete [] w.improved;
+    delete [] w.nswitches;
+
+    return w.lambda;
+}  // find_min_cycle_ratio_parallel
+
+// The cycle search walks from every node if more than 1 /
+// INCREMENTAL_SEARCH_RATIO of the nodes changed their policy edge.
+const int INCREMENTAL_SEARCH_RATIO = 4;
+
+// The dist update sweeps all edges if more than 1 / WORKLIST_RATIO of
+// the nodes are dirty, and at least once every FULL_UPDATE_PERIOD
+// iterations.
+const int WORKLIST_RATIO = 8;
+const int FULL_UPDATE_PERIOD = 16;
+
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
+{
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
+    int n = g->num_nodes();
+    int m = g->num_edges();
+
+    ninfo_how< num_t > *more_ninfo = new ninfo_how< num_t >[ n ];
+    ad_queue< int >    nodeq( n );
 
-    for ( int e = 0; e < m; ++e ) {
-        int u = g->source( e );
-        int d = g->edge_info( e );
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
 
-        if ( d < more_ninfo[ u ].dist ) {
-            more_ninfo[ u ].dist = ( float ) d;
-            more_ninfo[ u ].policy = e;
-            more_ninfo[ u ].target = g->target( e );
-            more_ninfo[ u ].einfo = d;
-#ifndef CYCLE_MEAN_VERSION
-            more_ninfo[ u ].einfo2 = g->edge_info2( e );
+    // STEP: Find the initial policy graph: the one of the last solve if
+    // there is one in si.warm, or the min weight outedges otherwise.
+    if ( si.warm && si.warm->is_valid( n ) ) {
+        for ( int v = 0; v < n; ++v ) {
+            int e = si.warm->policy[ v ];
+#ifdef DEBUG
+            assert( v == g->source( e ) );
 #endif
+
+            // If the policy edge of v has changed, take the min weight
+            // outedge of v instead.
+            if ( ( g->edge_info( e ) != si.warm->einfo[ v ] ) ||
+                 ( edge_ttime< num_t >( g, e ) != si.warm->einfo2[ v ] ) ) {
+                for ( int i = 0; i < g->outdegree( v ); ++i ) {
+                    if ( g->ith_target_edge_info( v, i ) < g->edge_info( e ) )
+                        e = g->ith_target_edge( v, i );
+                }
+            }
+
+            more_ninfo[ v ].dist = si.warm->dist[ v ];
+            more_ninfo[ v ].policy = e;
+            more_ninfo[ v ].target = g->target( e );
+            more_ninfo[ v ].einfo = g->edge_info( e );
+            more_ninfo[ v ].set_einfo2( edge_ttime< num_t >( g, e ) );
+        }
+    } else {
+        for ( int v = 0; v < n; ++v )
+            more_ninfo[ v ].dist = f_plus_infinity;
+
+        for ( int e = 0; e < m; ++e ) {
+            int u = g->source( e );
+            int d = g->edge_info( e );
+
+            if ( d < more_ninfo[ u ].dist ) {
+                more_ninfo[ u ].dist = ( dist_t ) d;
+                more_ninfo[ u ].policy = e;
+                more_ninfo[ u ].target = g->target( e );
+                more_ninfo[ u ].einfo = d;
+                more_ninfo[ u ].set_einfo2( edge_ttime< num_t >( g, e ) );
+            }
         }
     }
 
-    float lambda = lambda_so_far;
+    dist_t lambda = lambda_so_far;
+
+    if ( si.cycle )
+        si.cycle->reset( n );
+
+#ifdef BELLMAN_FORD_LIKE
+    // The instruction set of the dist update below.
+    int simd_level = ad_simd_level( ( long long ) n * sizeof( ninfo_how< num_t > ) );
+#endif
 
     int CHECK_LIMIT = n;
     int CHECK_COUNT = 0;
 
-    while ( true ) {
+    int  *cycle_nodes = new int[ n ];  // A node of each policy graph cycle.
+    bool catch_up = false;             // Improve the dists tree by tree if true.
+
+    // The policy edges changed by the last iteration are those out of
+    // changed_nodes[ 0 ], ..., changed_nodes[ nchanged - 1 ], or of any
+    // node if nchanged is n or more. nstamps is the next value to mark
+    // the nodes with in visited (see below).
+    int  *changed_nodes = new int[ n ];
+    int  nchanged = n;
+    int  nstamps = 0;
+
+    // The dirty nodes are those whose dist decreased after the in-edges
+    // of them were last checked in the dist update, each in dirtyq once.
+    // No other edge improves a dist unless lambda changed. ndirty is n
+    // or more until the first dist update.
+    ad_cqueue< int > dirtyq( n );
+    int  ndirty = n;
+    int  nworklist = 0;  // Number of dist updates since the last full one.
+    for ( int v = 0; v < n; ++v )
+        more_ninfo[ v ].in_queue = false;
+
+    // If threads were asked for, find_min_cycle_ratio_parallel() does
+    // the iterations instead.
+    int  nthreads = min( si.nthreads, max( 1, n / PHOWARD_MIN_NODES ) );
+    bool parallel = ( 0 < nthreads );
+    if ( parallel )
+        lambda = find_min_cycle_ratio_parallel( g, more_ninfo, &nodeq, lambda, nthreads, si );
+
+    while ( !parallel ) {
+
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            break;
 
 #ifdef REP_COUNT
         count[ 0 ]++;
@@ -84,54 +663,73 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         // STEP: Find the min mean cycle in the policy graph. Note that
         // each connected component in the policy graph has exactly one
         // cycle.
-        for ( int v = 0; v < n; ++v )
-            more_ninfo[ v ].visited = -1;
+        //
+        // A walk from v marks the nodes it visits with its own stamp in
+        // visited, and stops at a node visited before, by itself if it
+        // went around a cycle. The nodes visited in this iteration are
+        // those with visited >= base. Every node is walked from if the
+        // search is full. Otherwise, only the nodes whose policy edge
+        // changed are walked from: a cycle without such a node was a
+        // cycle in the last iteration too, so its mean is not less than
+        // lambda. The search is full in the first iteration, for the
+        // catch up of the dists, which needs every cycle, and if so many
+        // policy edges changed that walking from every node is faster.
+        bool full_search = true;
+#ifdef INCREMENTAL_CYCLE_SEARCH
+        full_search = ( catch_up || ( n <= nchanged ) ||
+                        ( n / INCREMENTAL_SEARCH_RATIO < nchanged ) ||
+                        ( INT_MAX - 2 - n < nstamps ) );
+#endif
+
+        int base = nstamps;
+        int nwalks = nchanged;
+        if ( full_search ) {
+            for ( int v = 0; v < n; ++v )
+                more_ninfo[ v ].visited = -1;
+            base = 0;
+            nwalks = n;
+            nstamps = n;
+        }
 
         int best_node = -1;  // A node in the cycle with the smallest mean.
+        int ncycles = 0;     // Number of cycles, one node of each in cycle_nodes.
 
 #ifdef PROGRESS
-        int NCYCLES = 0;
         int CYCLELEN = 0;
 #endif
 
-        // At the exit of this loop, visited field of every node must be >
-        // nonnegatice (-1 to be exact).
-        for ( int v = 0; v < n; ++v ) {
+        for ( int i = 0; i < nwalks; ++i ) {
+            int v = ( full_search ? i : changed_nodes[ i ] );
 
-            if ( 0 <= more_ninfo[ v ].visited )
+            if ( base <= more_ninfo[ v ].visited )
                 continue;
 
             // Search for a new cycle:
+            int stamp = ( full_search ? v : nstamps++ );
             int u = v;
             do {
-                more_ninfo[ u ].visited = v;
+                more_ninfo[ u ].visited = stamp;
                 u = more_ninfo[ u ].target;
-            } while ( -1 == more_ninfo[ u ].visited );
+            } while ( more_ninfo[ u ].visited < base );
 
-            if ( v != more_ninfo[ u ].visited )
+            if ( stamp != more_ninfo[ u ].visited )
                 continue;
 
-#ifdef PROGRESS
-            NCYCLES++;
-#endif
+            cycle_nodes[ ncycles++ ] = u;
 
             // Compute the mean of the cycle found. Note that u is a node on
             // this cycle.
-            int w = u;
-            int total_weight = 0;
-            int total_length = 0;
+            int     w = u;
+            total_t total_weight = 0;
+            total_t total_length = 0;
             do {
-#ifdef CYCLE_MEAN_VERSION
-                ++total_length;
-#else
-                total_length += more_ninfo[ u ].einfo2;
-#endif
+                total_length += more_ninfo[ u ].einfo2();
                 total_weight += more_ninfo[ u ].einfo;
                 u = more_ninfo[ u ].target;
             } while ( u != w );
 
             // Update lambda only if it decreases.
-            float new_lambda = ( float ) total_weight / total_length;
+            dist_t new_lambda = ( dist_t ) total_weight / total_length;
             if ( new_lambda < lambda ) {
                 lambda = new_lambda;
                 best_node = u;
@@ -140,10 +738,13 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 #ifdef PROGRESS
             CYCLELEN += total_length;
 #endif
-        } // for v
+        } // for i
+
+        // A mark for visited that no node has yet.
+        int mark = nstamps++;
 
 #ifdef PROGRESS
-        printf( "COUNTERS NCYCLES= %d CYCLELEN= %d\n", NCYCLES, CYCLELEN);
+        printf( "COUNTERS NCYCLES= %d CYCLELEN= %d\n", ncycles, CYCLELEN);
         int NUPDATES = 0;
         int QUEUELEN = 0;
         int NEDGES = 0;
@@ -152,7 +753,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         if ( -1 == best_node ) {
             // '-1 == best_node' implies that lambda has not changed. Then,
             // if there is no change for CHECK_LIMIT times, we decide that
-            // the algorithm converges and we exit.
+            // the algorithm converges and we exit. With
+            // POLICY_ITERATION_EXIT, the policy stops changing long before,
+            // and this is only a safeguard.
 
             if ( CHECK_COUNT++ > CHECK_LIMIT ) {
 #ifdef PROGRESS
@@ -165,6 +768,17 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             // '-1 != best_node' implies that lambda has changed.
             CHECK_COUNT = 0;
 
+            // Keep the cycle of best_node as the critical cycle. The
+            // policy does not change until the update below.
+            if ( si.cycle ) {
+                si.cycle->reset( n );
+                int u = best_node;
+                do {
+                    si.cycle->add( more_ninfo[ u ].policy );
+                    u = more_ninfo[ u ].target;
+                } while ( u != best_node );
+            }
+
 #ifdef REP_COUNT
             count[ 1 ] = count[ 0 ];
 #endif
@@ -175,12 +789,12 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             nodeq.init();
             nodeq.put( best_node );
 
-            // visited is greater than -1 for every node at this point. We
-            // can use this fact as follows. Below we only need a
-            // (visited/not visited) for visited. Thus, we designate that -1
-            // means "visited", and any other value means "not
-            // visited". Initially, every node is not visited.
-            more_ninfo[ best_node ].visited = -1;
+            // No node has mark in visited at this point. We can use this
+            // fact as follows. Below we only need a (visited/not visited)
+            // for visited. Thus, we designate that mark means "visited",
+            // and any other value means "not visited". Initially, every
+            // node is not visited.
+            more_ninfo[ best_node ].visited = mark;
 
 #ifdef MAKE_POLICY_CONNECTED
 #ifdef DEBUG
@@ -204,16 +818,11 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     ++NEDGES;
 #endif
 
-                    if ( -1 != more_ninfo[ u ].visited ) {
+                    if ( mark != more_ninfo[ u ].visited ) {
                         if ( v == more_ninfo[ u ].target ) {
-                            more_ninfo[ u ].visited = -1;
-#ifdef CYCLE_MEAN_VERSION
+                            more_ninfo[ u ].visited = mark;
                             more_ninfo[ u ].dist = more_ninfo[ v ].dist + 
-                                more_ninfo[ u ].einfo - lambda;
-#else
-                            more_ninfo[ u ].dist = more_ninfo[ v ].dist + 
-                                more_ninfo[ u ].einfo - lambda * more_ninfo[ u ].einfo2;
-#endif
+                                more_ninfo[ u ].einfo - lambda * more_ninfo[ u ].einfo2();
                             nodeq.put( u );
 #ifdef MAKE_POLICY_CONNECTED
 #ifdef DEBUG
@@ -245,19 +854,14 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     ++NEDGES;
 #endif
 
-                    if ( -1 != more_ninfo[ u ].visited ) {
-                        more_ninfo[ u ].visited = -1;
+                    if ( mark != more_ninfo[ u ].visited ) {
+                        more_ninfo[ u ].visited = mark;
                         more_ninfo[ u ].policy = g->ith_source_edge( v, i );
                         more_ninfo[ u ].target = v;
                         more_ninfo[ u ].einfo = g->ith_source_edge_info( v, i );
-#ifdef CYCLE_MEAN_VERSION
+                        more_ninfo[ u ].set_einfo2( ith_source_edge_ttime< num_t >( g, v, i ) );
                         more_ninfo[ u ].dist = more_ninfo[ v ].dist + 
-                            more_ninfo[ u ].einfo - lambda;
-#else
-                        more_ninfo[ u ].einfo2 = g->ith_source_edge_info2( v, i );
-                        more_ninfo[ u ].dist = more_ninfo[ v ].dist + 
-                            more_ninfo[ u ].einfo - lambda * more_ninfo[ u ].einfo2;
-#endif
+                            more_ninfo[ u ].einfo - lambda * more_ninfo[ u ].einfo2();
                         nodeq.put( u );
 #ifdef DEBUG
                         ++nvisited;
@@ -273,30 +877,117 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
         }  // if best_node != -1
 
+#ifdef POLICY_ITERATION_EXIT
+        // STEP: If the last iteration changed no policy edge, its dist
+        // updates were only the dists catching up with the policy, which
+        // may go on for many iterations with the same lambda, or forever
+        // if rounding makes a cycle a little shorter each time around.
+        // Let the dists catch up along each tree of the policy graph at
+        // once instead, from the node found on its cycle.
+        if ( catch_up ) {
+            for ( int i = 0; i < ncycles; ++i ) {
+#ifdef PROGRESS
+                NUPDATES += improve_tree_dists( g, more_ninfo, &nodeq, cycle_nodes[ i ], lambda, mark, &dirtyq, &ndirty );
+#else
+                improve_tree_dists( g, more_ninfo, &nodeq, cycle_nodes[ i ], lambda, mark, &dirtyq, &ndirty );
+#endif
+            }
+        }
+#endif
+
         // STEP: Update the dist of the other nodes:
         bool not_improved = true;
+        int  nswitches = 0;  // Number of policy edges changed.
+
+        // Check every edge if lambda changed, which changes the dists
+        // of the tree of best_node and the slack of every edge, or if
+        // there are many dirty nodes. Otherwise, check only the in-edges
+        // of the dirty nodes, and of the nodes whose dist they improve,
+        // like a queue-based Bellman-Ford, but of at most n nodes.
+        bool full_update = true;
+#ifdef WORKLIST_DIST_UPDATE
+        full_update = ( ( -1 != best_node ) || ( n <= ndirty ) ||
+                        ( n / WORKLIST_RATIO < ndirty ) ||
+                        ( FULL_UPDATE_PERIOD <= nworklist ) );
+#endif
+
+        if ( full_update ) {
+            while ( dirtyq.is_not_empty() )
+                more_ninfo[ dirtyq.get() ].in_queue = false;
+            ndirty = 0;
+            nworklist = 0;
+        } else {
+            ++nworklist;
+            for ( int k = 0; ( k < n ) && dirtyq.is_not_empty(); ++k ) {
+                int v = dirtyq.get();
+                more_ninfo[ v ].in_queue = false;
+                --ndirty;
+
+#ifdef PROGRESS
+                ++QUEUELEN;
+#endif
+
+                for ( int i = 0; i < g->indegree( v ); ++i ) {
+                    int u = g->ith_source_node( v, i );
+
+#ifdef PROGRESS
+                    ++NEDGES;
+#endif
+
+                    dist_t new_dist = more_ninfo[ v ].dist +
+                        g->ith_source_edge_info( v, i ) - lambda * ith_source_edge_ttime< num_t >( g, v, i );
+
+                    if ( EPSILON < ( more_ninfo[ u ].dist - new_dist ) ) {
+                        not_improved = false;
+                        if ( g->ith_source_edge( v, i ) != more_ninfo[ u ].policy ) {
+                            if ( nswitches < n )
+                                changed_nodes[ nswitches ] = u;
+                            ++nswitches;
+                        }
+                        more_ninfo[ u ].dist = new_dist;
+                        more_ninfo[ u ].policy = g->ith_source_edge( v, i );
+                        more_ninfo[ u ].target = v;
+                        more_ninfo[ u ].einfo = g->ith_source_edge_info( v, i );
+                        more_ninfo[ u ].set_einfo2( ith_source_edge_ttime< num_t >( g, v, i ) );
+                        ndirty += put_dirty( more_ninfo, &dirtyq, u );
+#ifdef PROGRESS
+                        ++NUPDATES;
+#endif
+                    }
+                }
+            }
+        }
 
 #ifdef BELLMAN_FORD_LIKE
-        for ( int e = 0; e < m; ++e ) {
+        for ( int e = 0; full_update && ( e < m ); ++e ) {
+            // Skip to the next edge that improves the dist of its
+            // source, many edges at a time if the CPU allows.
+            e = ad_find_improving_edge( simd_level, &more_ninfo[ 0 ].dist, sizeof( ninfo_how< num_t > ),
+                                        g->sources(), g->targets(), g->node_offset(),
+                                        g->edge_infos(), edge_ttimes< num_t >( g ), e, m, lambda );
+            if ( m == e )
+                break;
+
             int u = g->source( e );
             int v = g->target( e );
 
-#ifdef CYCLE_CYCLE_MEAN
-            float new_dist = more_ninfo[ v ].dist + 
-                g->edge_info( e ) - lambda;
-#else
-            float new_dist = more_ninfo[ v ].dist + 
-                g->edge_info( e ) - lambda * g->edge_info2( e );
-#endif
+            dist_t new_dist = more_ninfo[ v ].dist + 
+                g->edge_info( e ) - lambda * edge_ttime< num_t >( g, e );
 
             if ( EPSILON < ( more_ninfo[ u ].dist - new_dist ) ) {
                 not_improved = false;
+                if ( e != more_ninfo[ u ].policy ) {
+                    if ( nswitches < n )
+                        changed_nodes[ nswitches ] = u;
+                    ++nswitches;
+                }
                 more_ninfo[ u ].dist = new_dist;
                 more_ninfo[ u ].policy = e;
                 more_ninfo[ u ].target = v;
                 more_ninfo[ u ].einfo = g->edge_info( e );
-#ifndef CYCLE_CYCLE_MEAN
-                more_ninfo[ u ].einfo2 = g->edge_info2( e );
+                more_ninfo[ u ].set_einfo2( edge_ttime< num_t >( g, e ) );
+#ifdef WORKLIST_DIST_UPDATE
+                ndirty += put_dirty( more_ninfo, &dirtyq, u );
 #endif
 #ifdef PROGRESS
                 ++NUPDATES;
@@ -304,19 +995,14 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             }
         }
 #else
-        for ( int u = 0; u < n; ++u ) {
-            float d = more_ninfo[ u ].dist;
+        for ( int u = 0; full_update && ( u < n ); ++u ) {
+            dist_t d = more_ninfo[ u ].dist;
             int which = -1;
             for ( int i = 0; i < g->outdegree( u ); ++i ) {
                 int v = g->ith_target_node( u, i );
 
-#ifdef CYCLE_CYCLE_MEAN
-                float new_dist = more_ninfo[ v ].dist + 
-                    g->ith_target_edge_info( u, i ) - lambda;
-#else
-                float new_dist = more_ninfo[ v ].dist + 
-                    g->ith_target_edge_info( u, i ) - lambda * g->ith_target_edge_info2( u, i ); 
-#endif
+                dist_t new_dist = more_ninfo[ v ].dist + 
+                    g->ith_target_edge_info( u, i ) - lambda * ith_target_edge_ttime< num_t >( g, u, i ); 
 
                 if ( EPSILON < ( d - new_dist ) ) {
                     not_improved = false;
@@ -328,19 +1014,54 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                 }
             }
             if ( -1 != which ) {
+                if ( g->ith_target_edge( u, which ) != more_ninfo[ u ].policy ) {
+                    if ( nswitches < n )
+                        changed_nodes[ nswitches ] = u;
+                    ++nswitches;
+                }
                 more_ninfo[ u ].dist = d;
                 more_ninfo[ u ].policy = g->ith_target_edge( u, which );
                 more_ninfo[ u ].target = g->ith_target_node( u, which );
                 more_ninfo[ u ].einfo = g->ith_target_edge_info( u, which );
-#ifndef CYCLE_CYCLE_MEAN
-                more_ninfo[ u ].einfo2 = g->ith_target_edge_info2( u, which );
+                more_ninfo[ u ].set_einfo2( ith_target_edge_ttime< num_t >( g, u, which ) );
+#ifdef WORKLIST_DIST_UPDATE
+                ndirty += put_dirty( more_ninfo, &dirtyq, u );
 #endif
             }
         }
 #endif
 
 #ifdef PROGRESS
-        printf( "COUNTERS NUPDATES= %d QUEUELEN= %d NEDGES= %d\n", NUPDATES, QUEUELEN, NEDGES );
+        printf( "COUNTERS NUPDATES= %d NSWITCHES= %d QUEUELEN= %d NEDGES= %d\n",
+                NUPDATES, nswitches, QUEUELEN, NEDGES );
+#endif
+#ifdef REP_COUNT
+        count[ 2 ] += nswitches;
+#endif
+
+        nchanged = nswitches;
+#ifdef MAKE_POLICY_CONNECTED
+        // Many more policy edges may have changed above.
+        if ( -1 != best_node )
+            nchanged = n;
+#endif
+
+#ifdef POLICY_ITERATION_EXIT
+        // If no policy edge changed even after the dists caught up with
+        // the policy, no edge improves a dist by more than EPSILON but
+        // those out of the nodes the trees were improved from, so the
+        // policy, and hence lambda, is final.
+        if ( 0 == nswitches ) {
+            if ( catch_up ) {
+#ifdef PROGRESS
+                printf( "COUNTERS reason to exit: policy_stable\n" );
+#endif
+                break;
+            }
+            catch_up = true;
+        } else {
+            catch_up = false;
+        }
 #endif
 
         if ( not_improved ) {
@@ -358,6 +1079,19 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     printf( "REP_COUNT Iteration number= %d lambda= %10.2f\n", count[ 0 ], lambda );
 #endif
 
+    // Save the final policy graph for the next solve.
+    if ( si.warm ) {
+        si.warm->alloc( n );
+        for ( int v = 0; v < n; ++v ) {
+            si.warm->policy[ v ] = more_ninfo[ v ].policy;
+            si.warm->dist[ v ] = more_ninfo[ v ].dist;
+            si.warm->einfo[ v ] = more_ninfo[ v ].einfo;
+            si.warm->einfo2[ v ] = more_ninfo[ v ].einfo2();
+        }
+    }
+
+    delete [] cycle_nodes;
+    delete [] changed_nodes;
     delete [] more_ninfo;
 
     return lambda;
@@ -365,5 +1099,13 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
 #undef BELLMAN_FORD_LIKE
 #undef MAKE_POLICY_CONNECTED
+#undef POLICY_ITERATION_EXIT
+#undef INCREMENTAL_CYCLE_SEARCH
+#undef WORKLIST_DIST_UPDATE
+
+// Register the solver, instantiated for each numeric policy.
+const ad_solver howard_solver = { "howard", false,
+                                  AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &howard_solver );
 
 // End of file
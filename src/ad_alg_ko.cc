@@ -24,46 +24,66 @@
 // count[2] = number of arcs entering or leaving T(v)
 
 #include "ad_graph.h"
-#include "ad_pq.h"
+#include "ad_solver_pq.h"
 
-#ifndef ADD_SOURCE_NODE
-#error "ADD_SOURCE_NODE has to be defined for Karp-Orlin's algorithm."
-#endif
-
-typedef ad_pq< float, int >::ad_pq_node_ptr pq_ptr;
+typedef ad_solver_pq_handle pq_handle;
 
 // A heap node represents (edge_key(e), e) where e is an edge, and
 // edge_key is defined in the reference above.
 
 // More node info for Karp and Orlin's algorithm.
+template< class num_t >
 struct ninfo_ko {
-    int   dist;   // the weight of path from source.
-    int   length; // the length of path from source.
+    typename num_t::total_t dist;   // the weight of path from source.
+    typename num_t::total_t length; // the length of path from source.
 
     // fields for subtree management
     int   degree; // the real degree in the tree - 1.
     int   parent; // the parent node in the tree.
+    int   edge2parent; // the edge from the parent node.
     int   prev;   // the previous node in the inorder tree.
     int   next;   // the next node in the inorder tree.
     bool  visited; 
 };
 
+// Find the cycle that e_min = u -> v closes in the tree into cycle: u
+// is in the subtree rooted at v, so the cycle is e_min followed by the
+// tree path from v to u.
+template< class num_t >
+static
+void
+find_tree_cycle( const ninfo_ko< num_t > *more_ninfo, int n, int e_min, int u, int v, 
+                 ad_cycle *cycle )
+{
+    cycle->reset( n );
+    for ( int x = u; x != v; x = more_ninfo[ x ].parent )
+        cycle->add( more_ninfo[ x ].edge2parent );
+    cycle->add( e_min );
+    cycle->reverse();
+}  // find_tree_cycle
+
 /* ARGSUSED2 */
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
 {
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
     int n = g->num_nodes();
     int m = g->num_edges();
 
-    ad_pq< float, int > pq( m + 1 );
+    typename ad_solver_pq< dist_t >::type pq( m + 1 );
 
-    ninfo_ko  *more_ninfo = new ninfo_ko[ n ];
-    pq_ptr    *edge2heap = new pq_ptr[ m ];
+    ninfo_ko< num_t > *more_ninfo = new ninfo_ko< num_t >[ n ];
+    pq_handle         *edge2heap = new pq_handle[ m ];
 
-    float f_plus_infinity = ( float ) plus_infinity;
-    float f_minus_infinity = -f_plus_infinity;
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
+    dist_t f_minus_infinity = -f_plus_infinity;
 
     // STEP: Set the initial values of the fields of more_ninfo
     // array. Also construct the initial subtree rooted at the source
@@ -75,7 +95,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     // 1, 2, ..., (n-1). For a node in this list, prev and next point to
     // the previous and next nodes in the list.
     {
-        ninfo_ko *ptr = &more_ninfo[ SOURCE ];
+        ninfo_ko< num_t > *ptr = &more_ninfo[ SOURCE ];
 
         ptr->dist    = 0;
         ptr->length  = 0;
@@ -83,6 +103,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         ptr->prev    = n - 1;  // For circularity.
         ptr->next    = 1;
         ptr->parent  = -1;
+        ptr->edge2parent = -1;
         ptr->visited = false;
 
         for ( int v = 1; v < n; ++v ) {
@@ -94,11 +115,15 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             ptr->prev    = v - 1;
             ptr->next    = v + 1;
             ptr->parent  = SOURCE;
+            ptr->edge2parent = -1;  // An imaginary edge.
             ptr->visited = false;
         }
         ptr->next = SOURCE;  // For circularity.
     }
 
+    if ( si.cycle )
+        si.cycle->reset( n );
+
     // STEP: Initialize each edge key and insert them into the heap.
     {
         // Plus infinity in the heap is a special mark. Once found, it
@@ -106,24 +131,19 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         pq.put( f_plus_infinity, -1 );
 
         // Insert edge keys into the heap.
-#ifdef CYCLE_MEAN_VERSION
-        for ( int e = 0; e < m; ++e )
-            edge2heap[ e ] = pq.put( ( float ) g->edge_info( e ), e );
-#else
         for ( int e = 0; e < m; ++e ) {
-            if ( 0 < g->edge_info2( e ) )
-                edge2heap[ e ] = pq.put( ( float ) g->edge_info( e ) / g->edge_info2( e ), e );
+            if ( 0 < edge_ttime< num_t >( g, e ) )
+                edge2heap[ e ] = pq.put( ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e ), e );
             else
                 edge2heap[ e ] = pq.put( f_plus_infinity, e );
         }
-#endif
     }
 
     // STEP: Iterate until a cycle is found or +infinity in the heap is
     // seen.
-    float lambda;
+    dist_t lambda;
 #ifdef DEBUG
-    float prev_lambda = f_minus_infinity;
+    dist_t prev_lambda = f_minus_infinity;
 #endif
     while ( true ) {
 
@@ -134,6 +154,10 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         if ( lambda >= f_plus_infinity )
             goto done;
 
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            goto done;
+
 #ifdef REP_COUNT
         count[ 0 ]++;
 #endif
@@ -166,22 +190,20 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         // is not a parent of u.
         {
             // STEP: Find delta values for u->v.
-#ifdef CYCLE_MEAN_VERSION
-            int delta1 = more_ninfo[ u ].dist + g->edge_info( e_min ) - more_ninfo[ v ].dist;
-            int delta2 = more_ninfo[ u ].length + 1 - more_ninfo[ v ].length;
-#else
-            int delta1 = more_ninfo[ u ].dist + g->edge_info( e_min ) - more_ninfo[ v ].dist;
-            int delta2 = more_ninfo[ u ].length + g->edge_info2( e_min ) - more_ninfo[ v ].length;
-#endif
+            total_t delta1 = more_ninfo[ u ].dist + g->edge_info( e_min ) - more_ninfo[ v ].dist;
+            total_t delta2 = more_ninfo[ u ].length + edge_ttime< num_t >( g, e_min ) - more_ninfo[ v ].length;
 
             int w;
             {
-                ninfo_ko *ptr_w;
+                ninfo_ko< num_t > *ptr_w;
 
                 w = v;
                 for ( int total_degree = 0; total_degree >= 0; w = ptr_w->next ) {
-                    if ( w == u ) // Check for a cycle.
+                    if ( w == u ) { // Check for a cycle.
+                        if ( si.cycle )
+                            find_tree_cycle( more_ninfo, n, e_min, u, v, si.cycle );
                         goto done;
+                    }
                     ptr_w = &more_ninfo[ w ];
                     total_degree += ptr_w->degree;
                     ptr_w->dist += delta1;
@@ -226,6 +248,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             // lines.
             more_ninfo[ u ].degree++;
             more_ninfo[ v ].parent = u;
+            more_ninfo[ v ].edge2parent = e_min;
             int after_u = more_ninfo[ u ].next;
             more_ninfo[ u ].next = v;
             more_ninfo[ v ].prev = u;
@@ -237,7 +260,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         // change are those of which exactly one end point is in T(v).
         {
             // STEP2: Go over every edge entering T(v).
-            ninfo_ko *ptr_y;
+            ninfo_ko< num_t > *ptr_y;
             for ( int total_degree = 0, y = v; total_degree >= 0; y = ptr_y->next ) {
                 ptr_y = &more_ninfo[ y ];
                 total_degree += ptr_y->degree;
@@ -248,7 +271,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
                 for ( int i = 0; i < g->indegree( y ); ++i ) {
                     int e = g->ith_source_edge( y, i ); // e = x->y
-                    ninfo_ko *ptr_x = &more_ninfo[ g->ith_source_node( y, i ) ];
+                    ninfo_ko< num_t > *ptr_x = &more_ninfo[ g->ith_source_node( y, i ) ];
 
 #ifdef REP_COUNT
                     ++count[ 2 ];
@@ -257,14 +280,10 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     // T(v), i.e., x is not visited but y is visited. Only the
                     // key of an entering edge can change.
                     if ( ptr_x->visited != ptr_y->visited ) {
-#ifdef CYCLE_MEAN_VERSION
-                        int delta2 = ptr_x->length + 1 - ptr_y->length;
-#else            
-                        int delta2 = ptr_x->length + g->edge_info2( e ) - ptr_y->length;
-#endif
+                        total_t delta2 = ptr_x->length + edge_ttime< num_t >( g, e ) - ptr_y->length;
                         if ( delta2 > 0 ) {
-                            int delta1 = ptr_x->dist + g->edge_info( e ) - ptr_y->dist;
-                            pq.update_key( ( float ) delta1 / delta2, edge2heap[ e ] );
+                            total_t delta1 = ptr_x->dist + g->edge_info( e ) - ptr_y->dist;
+                            pq.update_key( ( dist_t ) delta1 / delta2, edge2heap[ e ] );
                         } else {
                             pq.update_key( f_plus_infinity, edge2heap[ e ] );
                         }
@@ -281,7 +300,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         // change are those of which exactly one end point is in T(v).
         {
             // STEP2: Go over every edge leaving T(v).
-            ninfo_ko *ptr_x;
+            ninfo_ko< num_t > *ptr_x;
             for ( int total_degree = 0, x = v; total_degree >= 0; x = ptr_x->next ) {
                 ptr_x = &more_ninfo[ x ];
                 total_degree += ptr_x->degree;
@@ -289,7 +308,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                 // If e's key changes, it cannot increase. Thus, y's key
                 // should be found among only the edges whose keys can
                 // change. These are exactly the leaving edges.
-                ninfo_ko *ptr_y;
+                ninfo_ko< num_t > *ptr_y;
                 for ( int i = 0; i < g->outdegree( x ); ++i ) {
                     int e = g->ith_target_edge( x, i ); // e = x->y
                     ptr_y = &more_ninfo[ g->ith_target_node( x, i ) ];
@@ -301,14 +320,10 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     // T(v), i.e., x is visited but y is not visited. Only the
                     // key of a leaving edge can change.
                     if ( ptr_x->visited != ptr_y->visited ) {
-#ifdef CYCLE_MEAN_VERSION
-                        int delta2 = ptr_x->length + 1 - ptr_y->length;
-#else            
-                        int delta2 = ptr_x->length + g->edge_info2( e ) - ptr_y->length;
-#endif
+                        total_t delta2 = ptr_x->length + edge_ttime< num_t >( g, e ) - ptr_y->length;
                         if ( delta2 > 0 ) {
-                            int delta1 = ptr_x->dist + g->edge_info( e ) - ptr_y->dist;
-                            pq.update_key( ( float ) delta1 / delta2, edge2heap[ e ] );
+                            total_t delta1 = ptr_x->dist + g->edge_info( e ) - ptr_y->dist;
+                            pq.update_key( ( dist_t ) delta1 / delta2, edge2heap[ e ] );
                         } else {
                             pq.update_key( f_plus_infinity, edge2heap[ e ] );
                         }
@@ -338,4 +353,10 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     return lambda;
 }  // find_min_cycle_ratio_for_scc
 
+// Register the solver, instantiated for each numeric policy; it needs
+// a source node.
+const ad_solver ko_solver = { "ko", true,
+                              AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &ko_solver );
+
 // End of file
@@ -10,71 +10,120 @@
 #include "ad_cqueue.h"
 
 // More node info for Lawler's algorithm.
+template< class num_t >
 struct ninfo_lawler {
-    float dist;
+    typename num_t::dist_t dist;
     int   not_included;
+    int   pred;          // the edge from the predecessor node.
 };
 
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+// Find a cycle of the predecessor edges in more_ninfo into cycle by
+// going backwards from node u, which was updated in the last phase, or
+// empty cycle if there is none.
+template< class num_t >
+static
+void
+find_pred_cycle( const ad_scc_view *g, const ninfo_lawler< num_t > *more_ninfo, 
+                 int u, ad_cycle *cycle )
 {
     int n = g->num_nodes();
-    int m = g->num_edges();
 
-    float f_plus_infinity = ( float ) plus_infinity;
+    cycle->reset( n );
 
-#ifdef CYCLE_MEAN_VERSION
-    float lower = f_plus_infinity;
-    float upper = -f_plus_infinity;
+    // After n steps backwards, u must be on a cycle.
+    for ( int i = 0; ( -1 != u ) && ( i < n ); ++i )
+        u = ( -1 == more_ninfo[ u ].pred ? -1 : g->source( more_ninfo[ u ].pred ) );
+    if ( -1 == u )
+        return;
 
-    // STEP: Determine lower and upper bounds on lambda:
-    for ( int e = 0; e < m; ++e ) {
-        min2( lower, ( float ) g->edge_info( e ) );
-        max2( upper, ( float ) g->edge_info( e ) );
-    }
+    int x = u;
+    do {
+        int e = more_ninfo[ x ].pred;
+        if ( ( -1 == e ) || ( cycle->len == n ) ) {
+            cycle->len = 0;
+            return;
+        }
+        cycle->add( e );
+        x = g->source( e );
+    } while ( x != u );
+
+    cycle->reverse();
+}  // find_pred_cycle
+
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
+{
+    typedef typename num_t::dist_t dist_t;
+
+    int n = g->num_nodes();
+    int m = g->num_edges();
+
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
+
+    // The critical cycle is the last negative cycle found, or the cycle
+    // of the initial upper bound if there is none.
+    if ( si.cycle )
+        si.cycle->reset( n );
 
-#else
 #ifdef IMPROVE_LAMBDA_BOUNDS
-    float upper = find_min_lambda( g, plus_infinity );
-    float lower = f_plus_infinity;
+    dist_t upper = find_min_lambda< num_t >( g, plus_infinity, si.cycle );
+    dist_t lower = f_plus_infinity;
 
     // Determine lower and upper bounds on lambda. 
     for ( int e = 0; e < m; ++e ) {
-        if ( 0 < g->edge_info2( e ) )
-            min2( lower, ( float ) g->edge_info( e ) / g->edge_info2( e ) );
+        if ( 0 < edge_ttime< num_t >( g, e ) )
+            min2( lower, ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e ) );
     }
 #else
-    float upper = 0.0;
-    float lower = f_plus_infinity;
+    dist_t upper = ( num_t::unit_ttime ? -f_plus_infinity : ( dist_t ) 0.0 );
+    dist_t lower = f_plus_infinity;
 
-    // Determine lower and upper bounds on lambda. Note that this step
-    // is different from the cycle mean case because it is difficult to
-    // define a tight upper bound. We take upper to be the sum of the
-    // arc weights.
+    // Determine lower and upper bounds on lambda. In the cycle mean
+    // case, we take upper to be the max arc weight. Otherwise, it is
+    // difficult to define a tight upper bound, so we take upper to be
+    // the sum of the arc weights.
     for ( int e = 0; e < m; ++e ) {
-        upper += g->edge_info( e );
-        if ( 0 < g->edge_info2( e ) )
-            min2( lower, ( float ) g->edge_info( e ) / g->edge_info2( e ) );
+        if ( num_t::unit_ttime )
+            max2( upper, ( dist_t ) g->edge_info( e ) );
+        else
+            upper += g->edge_info( e );
+        if ( 0 < edge_ttime< num_t >( g, e ) )
+            min2( lower, ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e ) );
     }
-#endif
 #endif
 
-    if ( lambda_so_far <= lower )
+    lambda_so_far = si.lambda_so_far( lambda_so_far );
+    if ( lambda_so_far <= lower ) {
+        if ( si.cycle )
+            si.cycle->len = 0;
         return lambda_so_far;
+    }
 
-    min2( upper, ( float ) 2.0 * lambda_so_far - lower );
+    // The cycle of upper is no longer critical if upper decreases.
+    if ( upper > ( dist_t ) 2.0 * lambda_so_far - lower ) {
+        upper = ( dist_t ) 2.0 * lambda_so_far - lower;
+        if ( si.cycle )
+            si.cycle->len = 0;
+    }
 
-    float lambda = upper;
+    dist_t lambda = upper;
 
-    ninfo_lawler      *more_ninfo = new ninfo_lawler[ n ];
-    ad_cqueue< int >  nodeq( n + 1 );  // +1 for insertion of END_PHASE node.
+    ninfo_lawler< num_t > *more_ninfo = new ninfo_lawler< num_t >[ n ];
+    ad_cqueue< int >      nodeq( n + 1 );  // +1 for insertion of END_PHASE node.
 
 #define END_PHASE -1
 
     while ( ( upper - lower ) > EPSILON ) {
 
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            break;
+
         // Determine the new lambda in the middle.
         lambda = ( upper + lower ) / 2;
 
@@ -91,9 +140,11 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
         more_ninfo[ SOURCE ].dist = 0;
         more_ninfo[ SOURCE ].not_included = 0;
+        more_ninfo[ SOURCE ].pred = -1;
         for ( int v = 1; v < n; ++v ) {
             more_ninfo[ v ].dist = f_plus_infinity;
             more_ninfo[ v ].not_included = 1;
+            more_ninfo[ v ].pred = -1;
         }
 
         nodeq.init();
@@ -102,6 +153,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
         bool found = true;
         int nphase = 0;
+        int last = -1;  // The last node whose dist decreased.
 
         while ( nphase < n ) {
             int u = nodeq.get();
@@ -114,25 +166,26 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     break;
                 }
 
+                if ( si.stopped() )
+                    break;
+
                 nodeq.put( END_PHASE );
                 continue;
             }
             else 
                 more_ninfo[u].not_included = 1;
 
-            float udist = more_ninfo[ u ].dist;
+            dist_t udist = more_ninfo[ u ].dist;
 
             for ( int i = 0; i < g->outdegree( u ); ++i ) {
                 int v = g->ith_target_node( u, i );
 
-#ifdef CYCLE_MEAN_VERSION
-                float new_dist = udist + g->ith_target_edge_info( u, i ) - lambda;
-#else
-                float new_dist = udist + g->ith_target_edge_info( u, i ) 
-                    - lambda * g->ith_target_edge_info2( u , i );
-#endif
+                dist_t new_dist = udist + g->ith_target_edge_info( u, i ) 
+                    - lambda * ith_target_edge_ttime< num_t >( g, u, i );
                 if ( new_dist < more_ninfo[ v ].dist ) {
                     more_ninfo[ v ].dist = new_dist;
+                    more_ninfo[ v ].pred = g->ith_target_edge( u, i );
+                    last = v;
                     if ( more_ninfo[ v ].not_included ) {
                         more_ninfo[ v ].not_included = 0;
                         nodeq.put( v );
@@ -143,6 +196,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         } // while nphase > n
 
         if ( found ) {
+            if ( si.cycle && !si.stopped() )
+                find_pred_cycle( g, more_ninfo, last, si.cycle );
+
             if ( ( upper - lambda ) < EPSILON2 )
                 break;
             upper = lambda;
@@ -151,6 +207,15 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             if ( ( lambda - lower ) < EPSILON2 )
                 break;
             lower = lambda;
+
+            // Stop if the other SCCs already have a smaller lambda.
+            dist_t so_far = si.lambda_so_far( lambda_so_far );
+            if ( so_far <= lower ) {
+                lambda = so_far;
+                if ( si.cycle )
+                    si.cycle->len = 0;
+                break;
+            }
         }
 
     }  // while 
@@ -162,4 +227,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     return lambda;
 }  // find_min_cycle_ratio_for_scc
 
+// Register the solver, instantiated for each numeric policy.
+const ad_solver lawler_solver = { "lawler", false,
+                                  AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &lawler_solver );
+
 // End of file
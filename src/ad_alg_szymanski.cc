@@ -28,77 +28,119 @@
 
 // More node info for Szymanski' algorithm. einfo and einfo2 fields
 // are redundant but needed for efficiency.
-struct ninfo_szymanski {
-    float dist;    // node distance or potential.
-    int   pred;    // predecessor node
-    int   einfo;   // weight of the edge from this node to its pred.
-#ifndef CYCLE_MEAN_VERSION
-    int   einfo2;  // transit time of the edge from this node to its pred.
-#endif
-    int   visited; // set if visited.
-    bool  changed; // set if dist is changed.
+template< class num_t >
+struct ninfo_szymanski : public ad_ttime_info< num_t > {
+    typename num_t::dist_t   dist;    // node distance or potential.
+    int                      pred;    // predecessor node
+    int                      pred_edge; // the edge from the predecessor node.
+    typename num_t::weight_t einfo;   // weight of the edge from this node to its pred.
+    int                      visited; // set if visited.
+    bool                     changed; // set if dist is changed.
 };
 
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+// Find a cycle of the pred edges in more_ninfo into cycle by going
+// backwards from node u, or empty cycle if there is none.
+template< class num_t >
+static
+void
+find_pred_cycle( const ninfo_szymanski< num_t > *more_ninfo, int n, int u, ad_cycle *cycle )
+{
+    cycle->reset( n );
+
+    // After n steps backwards, u must be on a cycle if there is one.
+    for ( int i = 0; ( -1 != u ) && ( i < n ); ++i )
+        u = more_ninfo[ u ].pred;
+    if ( -1 == u )
+        return;
+
+    int x = u;
+    do {
+        if ( ( -1 == more_ninfo[ x ].pred ) || ( cycle->len == n ) ) {
+            cycle->len = 0;
+            return;
+        }
+        cycle->add( more_ninfo[ x ].pred_edge );
+        x = more_ninfo[ x ].pred;
+    } while ( x != u );
+
+    cycle->reverse();
+}  // find_pred_cycle
+
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
 {
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
     const int INTERVAL = 10; // Szymanski's interval for cycle check.
 
     int n = g->num_nodes();
     int m = g->num_edges();
 
-    float f_plus_infinity = ( float ) plus_infinity;
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
 
-#ifdef CYCLE_MEAN_VERSION
-    float lower = f_plus_infinity;
-    float upper = -f_plus_infinity;
-
-    // STEP: Determine lower and upper bounds on lambda:
-    for ( int e = 0; e < m; ++e ) {
-        min2( lower, ( float ) g->edge_info( e ) );
-        max2( upper, ( float ) g->edge_info( e ) );
-    }
+    // The critical cycle is the last negative cycle found, or the cycle
+    // of the initial upper bound if there is none.
+    if ( si.cycle )
+        si.cycle->reset( n );
 
-#else
 #ifdef IMPROVE_LAMBDA_BOUNDS
-    float upper = find_min_lambda( g, plus_infinity );
-    float lower = f_plus_infinity;
+    dist_t upper = find_min_lambda< num_t >( g, plus_infinity, si.cycle );
+    dist_t lower = f_plus_infinity;
 
     // Determine lower and upper bounds on lambda. 
     for ( int e = 0; e < m; ++e ) {
-        if ( 0 < g->edge_info2( e ) )
-            min2( lower, ( float ) g->edge_info( e ) / g->edge_info2( e ) );
+        if ( 0 < edge_ttime< num_t >( g, e ) )
+            min2( lower, ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e ) );
     }
 #else
-    float upper = 0.0;
-    float lower = f_plus_infinity;
+    dist_t upper = ( num_t::unit_ttime ? -f_plus_infinity : ( dist_t ) 0.0 );
+    dist_t lower = f_plus_infinity;
 
-    // Determine lower and upper bounds on lambda. Note that this step
-    // is different from the cycle mean case because it is difficult to
-    // define a tight upper bound. We take upper to be the sum of the
-    // arc weights.
+    // Determine lower and upper bounds on lambda. In the cycle mean
+    // case, we take upper to be the max arc weight. Otherwise, it is
+    // difficult to define a tight upper bound, so we take upper to be
+    // the sum of the arc weights.
     for ( int e = 0; e < m; ++e ) {
-        upper += g->edge_info( e );
-        if ( 0 < g->edge_info2( e ) )
-            min2( lower, ( float ) g->edge_info( e ) / g->edge_info2( e ) );
+        if ( num_t::unit_ttime )
+            max2( upper, ( dist_t ) g->edge_info( e ) );
+        else
+            upper += g->edge_info( e );
+        if ( 0 < edge_ttime< num_t >( g, e ) )
+            min2( lower, ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e ) );
     }
-#endif
 #endif
 
-    if ( lambda_so_far <= lower )
+    lambda_so_far = si.lambda_so_far( lambda_so_far );
+    if ( lambda_so_far <= lower ) {
+        if ( si.cycle )
+            si.cycle->len = 0;
         return lambda_so_far;
+    }
 
-    min2( upper, ( float ) 2.0 * lambda_so_far - lower );
+    // The cycle of upper is no longer critical if upper decreases.
+    if ( upper > ( dist_t ) 2.0 * lambda_so_far - lower ) {
+        upper = ( dist_t ) 2.0 * lambda_so_far - lower;
+        if ( si.cycle )
+            si.cycle->len = 0;
+    }
 
-    float lambda = upper;
+    dist_t lambda = upper;
 
-    ninfo_szymanski   *more_ninfo = new ninfo_szymanski[ n ];
+    ninfo_szymanski< num_t > *more_ninfo = new ninfo_szymanski< num_t >[ n ];
 
     // STEP: Run Lawler's algorithm.
     while ( ( upper - lower ) > EPSILON ) {
 
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            break;
+
         // STEP: Determine the new lambda in the middle.
         lambda = ( upper + lower ) / 2;
 
@@ -124,7 +166,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         {
             // STEP2: Initialize the info of each node.
             {
-                ninfo_szymanski *ptr = &more_ninfo[ SOURCE ];
+                ninfo_szymanski< num_t > *ptr = &more_ninfo[ SOURCE ];
 
                 ptr->dist = 0.0;
                 ptr->pred = -1;  // -1 = not yet set.
@@ -160,29 +202,20 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     if ( more_ninfo[ u ].changed ) {
                         more_ninfo[ u ].changed = false;
 
-#ifdef CYCLE_MEAN_VERSION
-                        float reduced_dist = more_ninfo[ u ].dist - lambda;
-#else
-                        float udist = more_ninfo[ u ].dist;
-#endif
+                        dist_t udist = more_ninfo[ u ].dist;
 
                         for ( int i = 0; i < g->outdegree( u ); ++i ) {
                             int e_uv = g->ith_target_edge( u, i );
                             int v = g->target( e_uv );
                             int uv_info = g->edge_info( e_uv );
-#ifdef CYCLE_MEAN_VERSION
-                            float new_dist = reduced_dist + uv_info;
-#else
-                            int uv_info2 = g->edge_info2( e_uv );
-                            float new_dist = udist + uv_info - lambda * uv_info2;
-#endif
+                            int uv_info2 = edge_ttime< num_t >( g, e_uv );
+                            dist_t new_dist = udist + uv_info - lambda * uv_info2;
                             if ( new_dist < more_ninfo[ v ].dist ) {
                                 more_ninfo[ v ].dist = new_dist;
                                 more_ninfo[ v ].pred = u;
+                                more_ninfo[ v ].pred_edge = e_uv;
                                 more_ninfo[ v ].einfo = uv_info;
-#ifndef CYCLE_MEAN_VERSION
-                                more_ninfo[ v ].einfo2 = uv_info2;
-#endif
+                                more_ninfo[ v ].set_einfo2( uv_info2 );
                                 more_ninfo[ v ].changed = true;
                                 one_changed = true;
 #ifdef PROGRESS
@@ -199,6 +232,8 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     printf( "COUNTERS reason to exit: dist less than 0\n" );
 #endif
                     neg_cycle_found = true;
+                    if ( si.cycle )
+                        find_pred_cycle( more_ninfo, n, SOURCE, si.cycle );
                     goto update;
                 }
 
@@ -242,8 +277,8 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                         // Compute the mean of the cycle found. The node u is in
                         // this cycle.
                         int w = u;
-                        int total_length = 0;
-                        int total_weight = 0;
+                        total_t total_length = 0;
+                        total_t total_weight = 0;
 #ifdef DEBUG
                         int cycle_len = 0;
 #endif
@@ -253,16 +288,12 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                             assert( cycle_len++ < n );
                             assert( more_ninfo[ u ].pred >= 0 );
 #endif
-#ifdef CYCLE_MEAN_VERSION
-                            ++total_length;
-#else
-                            total_length += more_ninfo[ u ].einfo2;
-#endif
+                            total_length += more_ninfo[ u ].einfo2();
                             total_weight += more_ninfo[ u ].einfo;
                             u = more_ninfo[ u ].pred;
                         } while ( u != w );
             
-                        float new_lambda = ( float ) total_weight / total_length;
+                        dist_t new_lambda = ( dist_t ) total_weight / total_length;
                         if ( new_lambda < lambda ) {
                             // There is a negative cycle, and by definition of
                             // lambda, we know that min_lambda <= new_lambda. Thus,
@@ -278,6 +309,18 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                             lambda = new_lambda;
 #endif
                             neg_cycle_found = true;
+
+                            // Keep the cycle, collected backwards from
+                            // w, as the critical cycle.
+                            if ( si.cycle ) {
+                                si.cycle->reset( n );
+                                do {
+                                    si.cycle->add( more_ninfo[ u ].pred_edge );
+                                    u = more_ninfo[ u ].pred;
+                                } while ( u != w );
+                                si.cycle->reverse();
+                            }
+
                             goto update;
                         }
                     }  // for v
@@ -304,6 +347,15 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             if ( ( lambda - lower ) < EPSILON2 )
                 break;
             lower = lambda;
+
+            // Stop if the other SCCs already have a smaller lambda.
+            dist_t so_far = si.lambda_so_far( lambda_so_far );
+            if ( so_far <= lower ) {
+                lambda = so_far;
+                if ( si.cycle )
+                    si.cycle->len = 0;
+                break;
+            }
         }
 
     }  // while 
@@ -315,4 +367,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     return lambda;
 }  // find_min_cycle_ratio_for_scc
 
+// Register the solver, instantiated for each numeric policy.
+const ad_solver szymanski_solver = { "szymanski", false,
+                                     AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &szymanski_solver );
+
 // End of file
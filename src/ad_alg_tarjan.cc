@@ -40,78 +40,94 @@ enum STATUS {
 
 // More node info for Tarjan's algorithm. parent is redundant since
 // edge2parent's source node is parent.
+template< class num_t >
 struct ninfo_tarjan {
-    float  dist;         // the min distance from the source.
-    int    degree;       // the real degree in the tree - 1.
-    int    parent;       // the parent node in the tree.
-    int    edge2parent;  // the edge to the parent node.
-    int    prev;         // the previous node in the successor list.
-    int    next;         // the next node in the successor list.
-    STATUS status;       // status as in STATUS.
+    typename num_t::dist_t dist;         // the min distance from the source.
+    int                    degree;       // the real degree in the tree - 1.
+    int                    parent;       // the parent node in the tree.
+    int                    edge2parent;  // the edge to the parent node.
+    int                    prev;         // the previous node in the successor list.
+    int                    next;         // the next node in the successor list.
+    STATUS                 status;       // status as in STATUS.
 };
 
 // Note: The successor list in a tree corresponds to a preorder
 // traversal of its nodes.
 
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
 {
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
     int n = g->num_nodes();
     int m = g->num_edges();
 
-    float f_plus_infinity = ( float ) plus_infinity;
-
-#ifdef CYCLE_MEAN_VERSION
-    float lower = f_plus_infinity;
-    float upper = -f_plus_infinity;
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
 
-    // STEP: Determine lower and upper bounds on lambda:
-    for ( int e = 0; e < m; ++e ) {
-        min2( lower, ( float ) g->edge_info( e ) );
-        max2( upper, ( float ) g->edge_info( e ) );
-    }
+    // The critical cycle is the last negative cycle found, or the cycle
+    // of the initial upper bound if there is none.
+    if ( si.cycle )
+        si.cycle->reset( n );
 
-#else
 #ifdef IMPROVE_LAMBDA_BOUNDS
-    float upper = find_min_lambda( g, plus_infinity );
-    float lower = f_plus_infinity;
+    dist_t upper = find_min_lambda< num_t >( g, plus_infinity, si.cycle );
+    dist_t lower = f_plus_infinity;
 
     // Determine lower and upper bounds on lambda. 
     for ( int e = 0; e < m; ++e ) {
-        if ( 0 < g->edge_info2( e ) )
-            min2( lower, ( float ) g->edge_info( e ) / g->edge_info2( e ) );
+        if ( 0 < edge_ttime< num_t >( g, e ) )
+            min2( lower, ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e ) );
     }
 #else
-    float upper = 0.0;
-    float lower = f_plus_infinity;
+    dist_t upper = ( num_t::unit_ttime ? -f_plus_infinity : ( dist_t ) 0.0 );
+    dist_t lower = f_plus_infinity;
 
-    // Determine lower and upper bounds on lambda. Note that this step
-    // is different from the cycle mean case because it is difficult to
-    // define a tight upper bound. We take upper to be the sum of the
-    // arc weights.
+    // Determine lower and upper bounds on lambda. In the cycle mean
+    // case, we take upper to be the max arc weight. Otherwise, it is
+    // difficult to define a tight upper bound, so we take upper to be
+    // the sum of the arc weights.
     for ( int e = 0; e < m; ++e ) {
-        upper += g->edge_info( e );
-        if ( 0 < g->edge_info2( e ) )
-            min2( lower, ( float ) g->edge_info( e ) / g->edge_info2( e ) );
+        if ( num_t::unit_ttime )
+            max2( upper, ( dist_t ) g->edge_info( e ) );
+        else
+            upper += g->edge_info( e );
+        if ( 0 < edge_ttime< num_t >( g, e ) )
+            min2( lower, ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e ) );
     }
-#endif
 #endif
 
-    if ( lambda_so_far <= lower )
+    lambda_so_far = si.lambda_so_far( lambda_so_far );
+    if ( lambda_so_far <= lower ) {
+        if ( si.cycle )
+            si.cycle->len = 0;
         return lambda_so_far;
+    }
 
-    min2( upper, ( float ) 2.0 * lambda_so_far - lower );
+    // The cycle of upper is no longer critical if upper decreases.
+    if ( upper > ( dist_t ) 2.0 * lambda_so_far - lower ) {
+        upper = ( dist_t ) 2.0 * lambda_so_far - lower;
+        if ( si.cycle )
+            si.cycle->len = 0;
+    }
 
-    float lambda = upper;
+    dist_t lambda = upper;
 
-    ninfo_tarjan      *more_ninfo = new ninfo_tarjan[ n ];
+    ninfo_tarjan< num_t > *more_ninfo = new ninfo_tarjan< num_t >[ n ];
     ad_cqueue< int >  nodeq( n );
 
     // STEP: Run Lawler's algorithm.
     while ( ( upper - lower ) > EPSILON ) {
 
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            break;
+
         // STEP: Determine the new lambda in the middle.
         lambda = ( upper + lower ) / 2;
 
@@ -137,7 +153,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         {
             // STEP2: Initialize the info of each node.
             {
-                ninfo_tarjan *ptr = &more_ninfo[ SOURCE ];
+                ninfo_tarjan< num_t > *ptr = &more_ninfo[ SOURCE ];
 
                 ptr->dist = 0.0;
                 ptr->degree = -1;
@@ -185,11 +201,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     continue;
 
                 // STEP2: For each node v adjacent to node u, do:
-#ifdef CYCLE_MEAN_VERSION
-                float reduced_dist = more_ninfo[ u ].dist - lambda;
-#else
-                float udist = more_ninfo[ u ].dist;
-#endif
+                dist_t udist = more_ninfo[ u ].dist;
 
                 for ( int i = 0; i < g->outdegree( u ); ++i ) {
                     int v = g->ith_target_node( u, i );
@@ -204,12 +216,8 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 #endif
 
                     // STEP2: If v's dist decreases, update it.
-#ifdef CYCLE_MEAN_VERSION
-                    float new_dist = reduced_dist + g->edge_info( e_uv );
-#else
-                    float new_dist = udist + g->edge_info( e_uv ) -
-                        lambda * g->edge_info2( e_uv );
-#endif
+                    dist_t new_dist = udist + g->edge_info( e_uv ) -
+                        lambda * edge_ttime< num_t >( g, e_uv );
 
                     if ( new_dist < more_ninfo[ v ].dist ) {
                         more_ninfo[ v ].dist = new_dist;
@@ -244,13 +252,26 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                                     // u is in the subtree rooted at v, so a negative
                                     // cycle is found.
                                     neg_cycle_found = true;
+                                    more_ninfo[ v ].parent = u;
+                                    more_ninfo[ v ].edge2parent = e_uv;
+
+                                    // Keep the cycle, collected backwards
+                                    // from u, as the critical cycle.
+                                    if ( si.cycle ) {
+                                        si.cycle->reset( n );
+                                        int x = u;
+                                        do {
+                                            si.cycle->add( more_ninfo[ x ].edge2parent );
+                                            x = more_ninfo[ x ].parent;
+                                        } while ( x != u );
+                                        si.cycle->reverse();
+                                    }
+
                                     {
 #ifdef IMPROVE_UPPER_BOUND
-                                        more_ninfo[ v ].parent = u;
-                                        more_ninfo[ v ].edge2parent = e_uv;
                                         int x = u;
-                                        int total_weight = 0;
-                                        int total_length = 0;
+                                        total_t total_weight = 0;
+                                        total_t total_length = 0;
 #ifdef DEBUG
                                         int cycle_len = 0;
 #endif
@@ -265,16 +286,12 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                                             ++count[ 5 ];
 #endif
 
-#ifdef CYCLE_MEAN_VERSION
-                                            ++total_lengt;
-#else
-                                            total_length += g->edge_info2( more_ninfo[ x ].edge2parent );
-#endif
+                                            total_length += edge_ttime< num_t >( g, more_ninfo[ x ].edge2parent );
                                             total_weight += g->edge_info( more_ninfo[ x ].edge2parent );
                                             x = more_ninfo[ x ].parent;
                                         } while ( x != u );
 
-                                        float new_lambda = ( float ) total_weight / total_length;
+                                        dist_t new_lambda = ( dist_t ) total_weight / total_length;
                                         if ( new_lambda < lambda )
                                             lambda = new_lambda;
 
@@ -350,6 +367,15 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             if ( ( lambda - lower ) < EPSILON2 )
                 break;
             lower = lambda;
+
+            // Stop if the other SCCs already have a smaller lambda.
+            dist_t so_far = si.lambda_so_far( lambda_so_far );
+            if ( so_far <= lower ) {
+                lambda = so_far;
+                if ( si.cycle )
+                    si.cycle->len = 0;
+                break;
+            }
         }
 
     } // while 
@@ -357,6 +383,11 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     delete [] more_ninfo;
 
     return lambda;
-}  // find_min_cycle_mean_for_scc
+}  // find_min_cycle_ratio_for_scc
+
+// Register the solver, instantiated for each numeric policy.
+const ad_solver tarjan_solver = { "tarjan", false,
+                                  AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &tarjan_solver );
 
 // End of file
@@ -2,32 +2,37 @@
 // COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
 //
 // Using a successor graph, find the max and min realizable lambda in
-// the graph g. This code is taken from ad_alg_howard.cc.
+// the graph g. This code is taken from ad_alg_howard.cc. If cycle is
+// not NULL, it is set to a cycle whose ratio is the returned lambda.
 
 #include "ad_graph.h"
 
-struct ninfo_init {
-    int dist;
-    int visited;
-    int target;
-    int einfo;
-#ifndef CYCLE_MEAN_VERSION
-    int einfo2;
-#endif
+template< class num_t >
+struct ninfo_init : public ad_ttime_info< num_t > {
+    typename num_t::total_t  dist;
+    int                      visited;
+    int                      policy;
+    int                      target;
+    typename num_t::weight_t einfo;
 };
 
-float 
-find_lambda_bound( const ad_graph< ninfo > *g, 
-                   int plus_infinity, 
-                   bool which )
+template< class num_t >
+typename num_t::dist_t
+find_lambda_bound( const ad_scc_view *g, 
+                   typename num_t::total_t plus_infinity, 
+                   bool which,
+                   ad_cycle *cycle )
 {
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
     int n = g->num_nodes();
     int m = g->num_edges();
 
-    ninfo_init *more_ninfo = new ninfo_init[ n ];
+    ninfo_init< num_t > *more_ninfo = new ninfo_init< num_t >[ n ];
 
-    float f_plus_infinity = ( float ) plus_infinity;
-    float lambda = f_plus_infinity;
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
+    dist_t lambda = f_plus_infinity;
 
     if ( which ) {
         // Find min arc weights.
@@ -42,11 +47,10 @@ find_lambda_bound( const ad_graph< ninfo > *g,
     
             if ( d < more_ninfo[ u ].dist ) {
                 more_ninfo[ u ].dist = d;
+                more_ninfo[ u ].policy = e;
                 more_ninfo[ u ].target = g->target( e );
                 more_ninfo[ u ].einfo = d; 
-#ifndef CYCLE_MEAN_VERSION
-                more_ninfo[ u ].einfo2 = g->edge_info2( e );
-#endif
+                more_ninfo[ u ].set_einfo2( edge_ttime< num_t >( g, e ) );
             }
         }
     } else {
@@ -62,15 +66,16 @@ find_lambda_bound( const ad_graph< ninfo > *g,
     
             if ( d > more_ninfo[ u ].dist ) {
                 more_ninfo[ u ].dist = d;
+                more_ninfo[ u ].policy = e;
                 more_ninfo[ u ].target = g->target( e );
                 more_ninfo[ u ].einfo = d;      
-#ifndef CYCLE_MEAN_VERSION
-                more_ninfo[ u ].einfo2 = g->edge_info2( e );
-#endif
+                more_ninfo[ u ].set_einfo2( edge_ttime< num_t >( g, e ) );
             }
         }
     }
 
+    int best_node = -1;  // A node in the cycle with the smallest mean.
+
     for ( int v = 0; v < n; ++v ) {
     
         if ( 0 <= more_ninfo[ v ].visited )
@@ -88,27 +93,44 @@ find_lambda_bound( const ad_graph< ninfo > *g,
     
         // Compute the mean of the cycle found. Note that u is a node on
         // this cycle.
-        int w = u;
-        int total_weight = 0;
-        int total_length = 0;
+        int     w = u;
+        total_t total_weight = 0;
+        total_t total_length = 0;
         do {
-#ifdef CYCLE_MEAN_VERSION
-            ++total_length;
-#else
-            total_length += more_ninfo[ u ].einfo2;
-#endif
+            total_length += more_ninfo[ u ].einfo2();
             total_weight += more_ninfo[ u ].einfo;
             u = more_ninfo[ u ].target;
         } while ( u != w );
     
-        float new_lambda = ( float ) total_weight / total_length;
-        if ( new_lambda < lambda )
+        dist_t new_lambda = ( dist_t ) total_weight / total_length;
+        if ( new_lambda < lambda ) {
             lambda = new_lambda;
+            best_node = u;
+        }
     } // for v
 
+    if ( cycle ) {
+        cycle->reset( n );
+        if ( -1 != best_node ) {
+            int u = best_node;
+            do {
+                cycle->add( more_ninfo[ u ].policy );
+                u = more_ninfo[ u ].target;
+            } while ( u != best_node );
+        }
+    }
+
     delete [] more_ninfo;
 
     return lambda;
 }  // find_lambda_bound
 
+// Instantiate find_lambda_bound for each numeric policy.
+template ad_num16::dist_t find_lambda_bound< ad_num16 >( const ad_scc_view *, ad_num16::total_t, bool, ad_cycle * );
+template ad_num32::dist_t find_lambda_bound< ad_num32 >( const ad_scc_view *, ad_num32::total_t, bool, ad_cycle * );
+template ad_num64::dist_t find_lambda_bound< ad_num64 >( const ad_scc_view *, ad_num64::total_t, bool, ad_cycle * );
+template ad_mean16::dist_t find_lambda_bound< ad_mean16 >( const ad_scc_view *, ad_mean16::total_t, bool, ad_cycle * );
+template ad_mean32::dist_t find_lambda_bound< ad_mean32 >( const ad_scc_view *, ad_mean32::total_t, bool, ad_cycle * );
+template ad_mean64::dist_t find_lambda_bound< ad_mean64 >( const ad_scc_view *, ad_mean64::total_t, bool, ad_cycle * );
+
 // End of file
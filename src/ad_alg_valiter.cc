@@ -14,64 +14,105 @@
 
 #include "ad_graph.h"
 #include "ad_queue.h"
+#include "ad_simd.h"
 
 #define BELLMAN_FORD_LIKE
 //#define MAKE_POLICY_CONNECTED
 
-// More node info for Howard's algorithm. For a node u,
+// More node info for the value iteration algorithm. For a node u,
 // more_ninfo[u].policy = (u, more_ninfo[u].target). Carrying target,
-// einfo (weight of policy edge), and einfo2 (transit time) is
+// einfo (weight of policy edge), and einfo2() (transit time) is
 // redundant but it makes running time faster by eliminating access to
 // the edge list.
-struct ninfo_how {
-    float dist;    // node potential.
-    int   visited; // set if node is visited for some purpose.
-    int   policy;  // successor edge.
-    int   target;  // successor node
-    int   einfo;   // weight of policy edge.
-#ifndef CYCLE_MEAN_VERSION
-    int   einfo2;  // transit time of policy edge.
-#endif
+template< class num_t >
+struct ninfo_valiter : public ad_ttime_info< num_t > {
+    typename num_t::dist_t   dist;    // node potential.
+    int                      visited; // set if node is visited for some purpose.
+    int                      policy;  // successor edge.
+    int                      target;  // successor node
+    typename num_t::weight_t einfo;   // weight of policy edge.
 };
 
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
 {
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
     int n = g->num_nodes();
     int m = g->num_edges();
 
-    ninfo_how        *more_ninfo = new ninfo_how[ n ];
+    ninfo_valiter< num_t > *more_ninfo = new ninfo_valiter< num_t >[ n ];
+
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
 
-    float f_plus_infinity = ( float ) plus_infinity;
+    // STEP: Find the initial policy graph: the one of the last solve if
+    // there is one in si.warm, or the min weight outedges otherwise.
+    if ( si.warm && si.warm->is_valid( n ) ) {
+        for ( int v = 0; v < n; ++v ) {
+            int e = si.warm->policy[ v ];
+#ifdef DEBUG
+            assert( v == g->source( e ) );
+#endif
 
-    // STEP: Find the initial policy graph:
-    for ( int v = 0; v < n; ++v )
-        more_ninfo[ v ].dist = f_plus_infinity;
+            // If the policy edge of v has changed, take the min weight
+            // outedge of v instead.
+            if ( ( g->edge_info( e ) != si.warm->einfo[ v ] ) ||
+                 ( edge_ttime< num_t >( g, e ) != si.warm->einfo2[ v ] ) ) {
+                for ( int i = 0; i < g->outdegree( v ); ++i ) {
+                    if ( g->ith_target_edge_info( v, i ) < g->edge_info( e ) )
+                        e = g->ith_target_edge( v, i );
+                }
+            }
 
-    for ( int e = 0; e < m; ++e ) {
-        int u = g->source( e );
-        int d = g->edge_info( e );
+            more_ninfo[ v ].dist = si.warm->dist[ v ];
+            more_ninfo[ v ].policy = e;
+            more_ninfo[ v ].target = g->target( e );
+            more_ninfo[ v ].einfo = g->edge_info( e );
+            more_ninfo[ v ].set_einfo2( edge_ttime< num_t >( g, e ) );
+        }
+    } else {
+        for ( int v = 0; v < n; ++v )
+            more_ninfo[ v ].dist = f_plus_infinity;
 
-        if ( d < more_ninfo[ u ].dist ) {
-            more_ninfo[ u ].dist = ( float ) d;
-            more_ninfo[ u ].policy = e;
-            more_ninfo[ u ].target = g->target( e );
-            more_ninfo[ u ].einfo = d;
-#ifndef CYCLE_MEAN_VERSION
-            more_ninfo[ u ].einfo2 = g->edge_info2( e );
-#endif
+        for ( int e = 0; e < m; ++e ) {
+            int u = g->source( e );
+            int d = g->edge_info( e );
+
+            if ( d < more_ninfo[ u ].dist ) {
+                more_ninfo[ u ].dist = ( dist_t ) d;
+                more_ninfo[ u ].policy = e;
+                more_ninfo[ u ].target = g->target( e );
+                more_ninfo[ u ].einfo = d;
+                more_ninfo[ u ].set_einfo2( edge_ttime< num_t >( g, e ) );
+            }
         }
     }
 
-    float lambda = lambda_so_far;
+    dist_t lambda = lambda_so_far;
+
+    if ( si.cycle )
+        si.cycle->reset( n );
+
+#ifdef BELLMAN_FORD_LIKE
+    // The instruction set of the dist update below.
+    int simd_level = ad_simd_level( ( long long ) n * sizeof( ninfo_valiter< num_t > ) );
+#endif
 
     int CHECK_LIMIT = n;
     int CHECK_COUNT = 0;
 
     while ( true ) {
 
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            break;
+
 #ifdef REP_COUNT
         count[ 0 ]++;
 #endif
@@ -85,6 +126,8 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         for ( int v = 0; v < n; ++v )
             more_ninfo[ v ].visited = -1;
 
+        int best_node = -1;  // A node in the cycle with the smallest mean.
+
 #ifdef PROGRESS
         int NCYCLES = 0;
         int CYCLELEN = 0;
@@ -113,23 +156,20 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
             // Compute the mean of the cycle found. Note that u is a node on
             // this cycle.
-            int w = u;
-            int total_weight = 0;
-            int total_length = 0;
+            int     w = u;
+            total_t total_weight = 0;
+            total_t total_length = 0;
             do {
-#ifdef CYCLE_MEAN_VERSION
-                ++total_length;
-#else
-                total_length += more_ninfo[ u ].einfo2;
-#endif
+                total_length += more_ninfo[ u ].einfo2();
                 total_weight += more_ninfo[ u ].einfo;
                 u = more_ninfo[ u ].target;
             } while ( u != w );
 
             // Update lambda only if it decreases.
-            float new_lambda = ( float ) total_weight / total_length;
+            dist_t new_lambda = ( dist_t ) total_weight / total_length;
             if ( new_lambda < lambda ) {
                 lambda = new_lambda;
+                best_node = u;
 #ifdef PROGRESS
                 CHECK_COUNT = 0;
 #endif
@@ -148,6 +188,17 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         int NUPDATES = 0;
 #endif
 
+        // Keep the cycle of best_node as the critical cycle. The policy
+        // does not change until the update below.
+        if ( si.cycle && ( -1 != best_node ) ) {
+            si.cycle->reset( n );
+            int u = best_node;
+            do {
+                si.cycle->add( more_ninfo[ u ].policy );
+                u = more_ninfo[ u ].target;
+            } while ( u != best_node );
+        }
+
         if ( CHECK_COUNT++ > CHECK_LIMIT ) {
 #ifdef PROGRESS
             printf( "COUNTERS reason to exit: CHECK_LIMIT\n" );
@@ -160,25 +211,26 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
 #ifdef BELLMAN_FORD_LIKE
         for ( int e = 0; e < m; ++e ) {
+            // Skip to the next edge that improves the dist of its
+            // source, many edges at a time if the CPU allows.
+            e = ad_find_improving_edge( simd_level, &more_ninfo[ 0 ].dist, sizeof( ninfo_valiter< num_t > ),
+                                        g->sources(), g->targets(), g->node_offset(),
+                                        g->edge_infos(), edge_ttimes< num_t >( g ), e, m, lambda );
+            if ( m == e )
+                break;
+
             int u = g->source( e );
             int v = g->target( e );
 
-#ifdef CYCLE_MEAN_VERSION
-            float new_dist = more_ninfo[ v ].dist + 
-                g->edge_info( e ) - lambda;
-#else
-            float new_dist = more_ninfo[ v ].dist + 
-                g->edge_info( e ) - lambda * g->edge_info2( e );
-#endif
+            dist_t new_dist = more_ninfo[ v ].dist + 
+                g->edge_info( e ) - lambda * edge_ttime< num_t >( g, e );
             if ( EPSILON < ( more_ninfo[ u ].dist - new_dist ) ) {
                 not_improved = false;
                 more_ninfo[ u ].dist = new_dist;
                 more_ninfo[ u ].policy = e;
                 more_ninfo[ u ].target = v;
                 more_ninfo[ u ].einfo = g->edge_info( e );
-#ifndef CYCLE_MEAN_VERSION
-                more_ninfo[ u ].einfo2 = g->edge_info2( e );
-#endif
+                more_ninfo[ u ].set_einfo2( edge_ttime< num_t >( g, e ) );
 #ifdef PROGRESS
                 ++NUPDATES;
 #endif
@@ -186,18 +238,13 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         }
 #else
         for ( int u = 0; u < n; ++u ) {
-            float d = more_ninfo[ u ].dist;
+            dist_t d = more_ninfo[ u ].dist;
             int which = -1;
             for ( int i = 0; i < g->outdegree( u ); ++i ) {
                 int v = g->ith_target_node( u, i );
 
-#ifdef CYCLE_MEAN_VERSION
-                float new_dist = more_ninfo[ v ].dist + 
-                    g->ith_target_edge_info( u, i ) - lambda;
-#else
-                float new_dist = more_ninfo[ v ].dist + 
-                    g->ith_target_edge_info( u, i ) - lambda * g->ith_target_edge_info2( u, i ); 
-#endif
+                dist_t new_dist = more_ninfo[ v ].dist + 
+                    g->ith_target_edge_info( u, i ) - lambda * ith_target_edge_ttime< num_t >( g, u, i ); 
                 if ( EPSILON < ( d - new_dist ) ) {
                     not_improved = false;
                     d = new_dist;
@@ -212,9 +259,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                 more_ninfo[ u ].policy = g->ith_target_edge( u, which );
                 more_ninfo[ u ].target = g->ith_target_node( u, which );
                 more_ninfo[ u ].einfo = g->ith_target_edge_info( u, which );
-#ifndef CYCLE_MEAN_VERSION
-                more_ninfo[ u ].einfo2 = g->ith_target_edge_info2( u, which );
-#endif
+                more_ninfo[ u ].set_einfo2( ith_target_edge_ttime< num_t >( g, u, which ) );
             }
         }
 #endif
@@ -238,6 +283,17 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     printf( "REP_COUNT Iteration number= %d lambda= %10.2f\n", count[ 0 ], lambda );
 #endif
 
+    // Save the final policy graph for the next solve.
+    if ( si.warm ) {
+        si.warm->alloc( n );
+        for ( int v = 0; v < n; ++v ) {
+            si.warm->policy[ v ] = more_ninfo[ v ].policy;
+            si.warm->dist[ v ] = more_ninfo[ v ].dist;
+            si.warm->einfo[ v ] = more_ninfo[ v ].einfo;
+            si.warm->einfo2[ v ] = more_ninfo[ v ].einfo2();
+        }
+    }
+
     delete [] more_ninfo;
 
     return lambda;
@@ -246,4 +302,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 #undef BELLMAN_FORD_LIKE
 #undef MAKE_POLICY_CONNECTED
 
+// Register the solver, instantiated for each numeric policy.
+const ad_solver valiter_solver = { "valiter", false,
+                                   AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &valiter_solver );
+
 // End of file
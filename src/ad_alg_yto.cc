@@ -24,13 +24,9 @@
 // count[2] = number of arcs entering or leaving T(v)
 
 #include "ad_graph.h"
-#include "ad_pq.h"
+#include "ad_solver_pq.h"
 
-#ifndef ADD_SOURCE_NODE
-#error "ADD_SOURCE_NODE has to be defined for Young-Tarjan-Orlin's algorithm."
-#endif
-
-typedef ad_pq< float, int >::ad_pq_node_ptr pq_ptr;
+typedef ad_solver_pq_handle pq_handle;
 
 // A heap node represents (ekey(v), key(v)) where v is a node, and
 // key(v) is a predecessor edge of v that has the smallest edge key,
@@ -38,38 +34,62 @@ typedef ad_pq< float, int >::ad_pq_node_ptr pq_ptr;
 // above. edge_key array holds edge keys.
 
 // More node info for Young-Tarjan-Orlin's algorithm.
+template< class num_t >
 struct ninfo_yto {
-    int    dist;      // the weight of path from source.
-    int    length;    // the length of path from source.
+    typename num_t::total_t dist;   // the weight of path from source.
+    typename num_t::total_t length; // the length of path from source.
     int    key;       // node key (the edge w/ edge key = ekey)
-    float  ekey;      // the inedge w/ the min key
-    pq_ptr node2heap; // ptr to the heap node w/ key = ekey
+    typename num_t::dist_t ekey;    // the inedge w/ the min key
+    pq_handle node2heap; // handle of the heap node w/ key = ekey
 
     // fields for subtree management
     int    degree;    // the real degree in the tree - 1.
     int    parent;    // the parent node in the tree.
+    int    edge2parent; // the edge from the parent node.
     int    prev;      // the previous node in the inorder tree.
     int    next;      // the next node in the inorder tree.
     bool   visited;   // set if this node is in the tree
 };
 
+// Find the cycle that e_min = u -> v closes in the tree into cycle: u
+// is in the subtree rooted at v, so the cycle is e_min followed by the
+// tree path from v to u.
+template< class num_t >
+static
+void
+find_tree_cycle( const ninfo_yto< num_t > *more_ninfo, int n, int e_min, int u, int v, 
+                 ad_cycle *cycle )
+{
+    cycle->reset( n );
+    for ( int x = u; x != v; x = more_ninfo[ x ].parent )
+        cycle->add( more_ninfo[ x ].edge2parent );
+    cycle->add( e_min );
+    cycle->reverse();
+}  // find_tree_cycle
+
 /* ARGSUSED2 */
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far )
+template< class num_t >
+static
+typename num_t::dist_t
+find_min_cycle_ratio_for_scc( const ad_scc_view *g, 
+                              typename num_t::total_t plus_infinity,
+                              typename num_t::dist_t lambda_so_far,
+                              const sinfo& si )
 {
+    typedef typename num_t::total_t total_t;
+    typedef typename num_t::dist_t  dist_t;
+
     int n = g->num_nodes();
     int m = g->num_edges();
 
-    ad_pq< float, int > pq( n + 1 );
+    typename ad_solver_pq< dist_t >::type pq( n + 1 );
 
-    ninfo_yto *more_ninfo = new ninfo_yto[ n ];
-    float      *edge_key = new float[ m ];
+    ninfo_yto< num_t > *more_ninfo = new ninfo_yto< num_t >[ n ];
+    dist_t             *edge_key = new dist_t[ m ];
 
     // Plus and minus infinity: upper and lower bounds on lambda.
-    float f_plus_infinity = ( float ) plus_infinity;
-    float f_minus_infinity = -f_plus_infinity;
+    dist_t f_plus_infinity = ( dist_t ) plus_infinity;
+    dist_t f_minus_infinity = -f_plus_infinity;
 
     // STEP: Set the initial values of the fields of more_ninfo
     // array. Also construct the initial subtree rooted at the source
@@ -81,7 +101,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     // 1, 2, ..., (n-1). For a node in this list, prev and next point to
     // the previous and next nodes in the list.
     {
-        ninfo_yto *ptr = &more_ninfo[ SOURCE ];
+        ninfo_yto< num_t > *ptr = &more_ninfo[ SOURCE ];
 
         // ptr->key is not used at all.
         // ptr->ekey is not used at all.
@@ -92,6 +112,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         ptr->prev    = n - 1;  // For circularity.
         ptr->next    = 1;
         ptr->parent  = -1;
+        ptr->edge2parent = -1;
         ptr->visited = false;  
 
         for ( int v = 1; v < n; ++v ) {
@@ -108,27 +129,27 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             ptr->prev    = v - 1;
             ptr->next    = v + 1;
             ptr->parent  = SOURCE;
+            ptr->edge2parent = -1;  // An imaginary edge.
             ptr->visited = false;
         }
         ptr->next = SOURCE; // For circularity.
     }
 
+    if ( si.cycle )
+        si.cycle->reset( n );
+
     // STEP: Initialize the key of each node and edge, and insert the
     // node keys into the heap. The edge key of an edge is initially its
     // weight in g. The key of a node is the inedge with the min
     // key. The ekey of a node is the key of the node's key edge.
     {
         // Find the keys.
-        ninfo_yto *ptr;
+        ninfo_yto< num_t > *ptr;
         for ( int e = 0; e < m; ++e ) {
-#ifdef CYCLE_MEAN_VERSION
-            edge_key[ e ] = ( float ) g->edge_info( e );
-#else
-            if ( 0 < g->edge_info2( e ) )
-                edge_key[ e ] = ( float ) g->edge_info( e ) / g->edge_info2( e );
+            if ( 0 < edge_ttime< num_t >( g, e ) )
+                edge_key[ e ] = ( dist_t ) g->edge_info( e ) / edge_ttime< num_t >( g, e );
             else
                 edge_key[ e ] = f_plus_infinity;
-#endif
             ptr = &more_ninfo[ g->target( e ) ];
             if ( edge_key[ e ] <= ptr->ekey ) {
                 // <= is needed because f_plus_infinity <= f_plus_infinity.
@@ -153,9 +174,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
 
     // STEP: Iterate until a cycle is found or +infinity in the heap is
     // seen.
-    float lambda;
+    dist_t lambda;
 #ifdef DEBUG
-    float prev_lambda = f_minus_infinity;
+    dist_t prev_lambda = f_minus_infinity;
 #endif
     while ( true ) {
 
@@ -166,6 +187,10 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         if ( lambda >= f_plus_infinity )
             goto done;
 
+        // Give up if another solver finished first.
+        if ( si.stopped() )
+            goto done;
+
 #ifdef REP_COUNT
         count[ 0 ]++;
 #endif
@@ -198,13 +223,8 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         // is not a parent of u.
         {
             // STEP2: Find delta values for u->v.  
-#ifdef CYCLE_MEAN_VERSION
-            int delta1 = more_ninfo[ u ].dist + g->edge_info( e_min ) - more_ninfo[ v ].dist;
-            int delta2 = more_ninfo[ u ].length + 1 - more_ninfo[ v ].length;
-#else
-            int delta1 = more_ninfo[ u ].dist + g->edge_info( e_min ) - more_ninfo[ v ].dist;
-            int delta2 = more_ninfo[ u ].length + g->edge_info2( e_min ) - more_ninfo[ v ].length;
-#endif
+            total_t delta1 = more_ninfo[ u ].dist + g->edge_info( e_min ) - more_ninfo[ v ].dist;
+            total_t delta2 = more_ninfo[ u ].length + edge_ttime< num_t >( g, e_min ) - more_ninfo[ v ].length;
 
             // STEP2: Using the delta values, update the dist and length of
             // each node in T(v). Also check if u is in
@@ -215,11 +235,14 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             // computing the delta values.
             int w;
             {
-                ninfo_yto *ptr_w;
+                ninfo_yto< num_t > *ptr_w;
                 w = v;
                 for ( int total_degree = 0; total_degree >= 0; w = ptr_w->next ) {
-                    if ( w == u )  // Check for a cycle.
+                    if ( w == u ) {  // Check for a cycle.
+                        if ( si.cycle )
+                            find_tree_cycle( more_ninfo, n, e_min, u, v, si.cycle );
                         goto done;
+                    }
                     ptr_w = &more_ninfo[ w ];
                     total_degree += ptr_w->degree;
                     ptr_w->dist += delta1;
@@ -264,6 +287,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
             // lines.
             more_ninfo[ u ].degree++;
             more_ninfo[ v ].parent = u;
+            more_ninfo[ v ].edge2parent = e_min;
             int after_u = more_ninfo[ u ].next;
             more_ninfo[ u ].next = v;
             more_ninfo[ v ].prev = u;
@@ -275,7 +299,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         // change are those of which exactly one end point is in T(v).
         {
             // STEP2: Go over every edge entering T(v).
-            ninfo_yto *ptr_y;
+            ninfo_yto< num_t > *ptr_y;
             for ( int total_degree = 0, y = v; total_degree >= 0; y = ptr_y->next ) {
                 ptr_y = &more_ninfo[ y ];
                 total_degree += ptr_y->degree;
@@ -291,7 +315,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                 ptr_y->ekey = f_plus_infinity;
                 for ( int i = 0; i < g->indegree( y ); ++i ) {
                     int e = g->ith_source_edge( y, i ); // e = x->y
-                    ninfo_yto *ptr_x = &more_ninfo[ g->ith_source_node( y, i ) ];
+                    ninfo_yto< num_t > *ptr_x = &more_ninfo[ g->ith_source_node( y, i ) ];
 
 #ifdef REP_COUNT
                     ++count[ 2 ];
@@ -301,13 +325,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     // T(v), i.e., x is not visited but y is visited. Only the
                     // key of an entering edge can change.
                     if ( ptr_x->visited != ptr_y->visited ) {
-#ifdef CYCLE_MEAN_VERSION
-                        int delta2 = ptr_x->length + 1 - ptr_y->length;
-#else            
-                        int delta2 = ptr_x->length + g->edge_info2( e ) - ptr_y->length;
-#endif
+                        total_t delta2 = ptr_x->length + edge_ttime< num_t >( g, e ) - ptr_y->length;
                         if ( delta2 > 0 )
-                            edge_key[ e ] = ( float ) ( ptr_x->dist + g->edge_info( e ) - ptr_y->dist ) / delta2;
+                            edge_key[ e ] = ( dist_t ) ( ptr_x->dist + g->edge_info( e ) - ptr_y->dist ) / delta2;
                         else
                             edge_key[ e ] = f_plus_infinity;
 #ifdef PROGRESS
@@ -332,7 +352,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
         // change are those of which exactly one end point is in T(v).
         {
             // STEP2: Go over every edge leaving T(v).
-            ninfo_yto *ptr_x;
+            ninfo_yto< num_t > *ptr_x;
             for ( int total_degree = 0, x = v; total_degree >= 0; x = ptr_x->next ) {
                 ptr_x = &more_ninfo[ x ];
                 total_degree += ptr_x->degree;
@@ -340,7 +360,7 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                 // If e's key changes, it cannot increase. Thus, y's key
                 // should be found among only the edges whose keys can
                 // change. These are exactly the leaving edges.
-                ninfo_yto *ptr_y;
+                ninfo_yto< num_t > *ptr_y;
                 for ( int i = 0; i < g->outdegree( x ); ++i ) {
                     int e = g->ith_target_edge( x, i ); // e = x->y
                     ptr_y = &more_ninfo[ g->ith_target_node( x, i ) ];
@@ -353,13 +373,9 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
                     // T(v), i.e., x is visited but y is not visited. Only the
                     // key of a leaving edge can change.
                     if ( ptr_x->visited != ptr_y->visited ) {
-#ifdef CYCLE_MEAN_VERSION
-                        int delta2 = ptr_x->length + 1 - ptr_y->length;
-#else            
-                        int delta2 = ptr_x->length + g->edge_info2( e ) - ptr_y->length;
-#endif
+                        total_t delta2 = ptr_x->length + edge_ttime< num_t >( g, e ) - ptr_y->length;
                         if ( delta2 > 0 )
-                            edge_key[ e ] = ( float ) ( ptr_x->dist + g->edge_info( e ) - ptr_y->dist ) / delta2;
+                            edge_key[ e ] = ( dist_t ) ( ptr_x->dist + g->edge_info( e ) - ptr_y->dist ) / delta2;
                         else
                             edge_key[ e ] = f_plus_infinity;
 
@@ -397,4 +413,10 @@ find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g,
     return lambda;
 }  // find_min_cycle_ratio_for_scc
 
+// Register the solver, instantiated for each numeric policy; it needs
+// a source node.
+const ad_solver yto_solver = { "yto", true,
+                               AD_SOLVER_FUNCS( find_min_cycle_ratio_for_scc ) };
+static ad_solver_registrar registrar( &yto_solver );
+
 // End of file
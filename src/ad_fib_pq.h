@@ -0,0 +1,329 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+#ifndef AD_FIB_PQ_INCLUDED
+#define AD_FIB_PQ_INCLUDED
+
+#include "ad_globals.h"
+
+// A min priority queue implementation based on Fibonacci heaps. It has
+// the same interface as ad_pq.
+//
+// The heap is a list of trees in which each node has a key no smaller
+// than the key of its parent. The roots and the children of each node
+// are kept in circular doubly linked lists. Decreasing a key cuts the
+// node to the root list in O(1) amortized time, cutting marked
+// ancestors too. Increasing a key removes the node, moving its
+// children to the root list, and reinserts it; if the node was the
+// min, the roots are consolidated by degree to find the new min.
+//
+// As in ad_pq, a node is known by its handle, its number in the order
+// of insertion, and the node fields are kept in arrays indexed by the
+// handle.
+
+template< class key_t, class info_t >
+class ad_fib_pq {
+public:
+
+    // Handle of a heap node.
+    typedef int ad_pq_handle;
+
+    // Constructors.
+    ad_fib_pq()
+    {
+        alloc( MAX_ALLOC_SIZE );
+    }
+
+    ad_fib_pq( int n )
+    {
+        alloc( n + 1 );
+    }
+
+    // Destructor.
+    ~ad_fib_pq()
+    {
+        delete [] node_key;
+        delete [] node_info;
+        delete [] parent;
+        delete [] child;
+        delete [] left;
+        delete [] right;
+        delete [] degree;
+        delete [] mark;
+        delete [] roots;
+    }
+
+    // Insert (key, info) into the heap and return the handle of its
+    // node.
+    ad_pq_handle put( const key_t& key, const info_t& info )
+    {
+        if ( len <= nnodes )
+            resize();
+
+        int h = nnodes++;
+        node_key[ h ] = key;
+        node_info[ h ] = info;
+        child[ h ] = NIL;
+        degree[ h ] = 0;
+        add_root( h );
+
+        return h;
+    }  // put
+
+    // Update node h's key.
+    void update_key( const key_t& key, ad_pq_handle h )
+    {
+        if ( key < node_key[ h ] ) {
+            node_key[ h ] = key;
+            int p = parent[ h ];
+            if ( ( NIL != p ) && ( key < node_key[ p ] ) ) {
+                cut( h );
+                cascading_cut( p );
+            }
+            if ( key < node_key[ min_node ] )
+                min_node = h;
+        } else if ( key > node_key[ h ] ) {
+            // Remove h with its old key so that min_node stays valid.
+            remove( h );
+            node_key[ h ] = key;
+            add_root( h );
+        }
+        /* else do nothing */
+    }  // update_key
+
+    // Update node h's all information.
+    void update_node( const key_t& key, const info_t& info, ad_pq_handle h )
+    {
+        node_info[ h ] = info;
+        update_key( key, h );
+    }
+
+    // Return the properties of the min node:
+    key_t getkey()
+    {
+#ifdef DEBUG
+        assert( NIL != min_node );
+#endif
+        return node_key[ min_node ];
+    }
+    info_t getinfo()
+    {
+#ifdef DEBUG
+        assert( NIL != min_node );
+#endif
+        return node_info[ min_node ];
+    }
+
+private:
+    static const int NIL = -1;
+
+    // Max degree + 1: the degree of a node is O(log n), bounded by
+    // log_phi(n) < 45 for n < 2^31.
+    static const int MAX_DEGREE = 48;
+
+    int len;         // Size of the arrays.
+    int nnodes;      // Number of nodes ever inserted.
+    int min_node;    // The min root, or NIL if the heap is empty.
+
+    // Node h has key node_key[h] and info node_info[h]. Its parent is
+    // parent[h] (NIL for a root), and its degree[h] children form a
+    // circular list through left and right starting at child[h].
+    // mark[h] is true if h lost a child since it became a child
+    // itself.
+    key_t  *node_key;
+    info_t *node_info;
+    int    *parent;
+    int    *child;
+    int    *left;
+    int    *right;
+    int    *degree;
+    bool   *mark;
+
+    int    *roots;   // Scratch space for consolidate().
+
+private:
+    void alloc( int n )
+    {
+        nnodes = 0;
+        min_node = NIL;
+        len = max( n, 2 );
+        node_key = new key_t[ len ];
+        node_info = new info_t[ len ];
+        parent = new int[ len ];
+        child = new int[ len ];
+        left = new int[ len ];
+        right = new int[ len ];
+        degree = new int[ len ];
+        mark = new bool[ len ];
+        roots = new int[ len ];
+    }  // alloc
+
+    // Insert h after pos in a circular list.
+    void splice( int pos, int h )
+    {
+        int r = right[ pos ];
+        left[ h ] = pos;
+        right[ h ] = r;
+        left[ r ] = h;
+        right[ pos ] = h;
+    }
+
+    // Remove h from its circular list.
+    void unlink( int h )
+    {
+        right[ left[ h ] ] = right[ h ];
+        left[ right[ h ] ] = left[ h ];
+    }
+
+    // Add h, whose subtree is kept, to the root list.
+    void add_root( int h )
+    {
+        parent[ h ] = NIL;
+        mark[ h ] = false;
+        if ( NIL == min_node ) {
+            left[ h ] = right[ h ] = h;
+            min_node = h;
+        } else {
+            splice( min_node, h );
+            if ( node_key[ h ] < node_key[ min_node ] )
+                min_node = h;
+        }
+    }  // add_root
+
+    // Make y a child of root x. y is not in any list.
+    void link( int y, int x )
+    {
+        parent[ y ] = x;
+        mark[ y ] = false;
+        int c = child[ x ];
+        if ( NIL == c ) {
+            left[ y ] = right[ y ] = y;
+            child[ x ] = y;
+        } else {
+            splice( c, y );
+        }
+        ++degree[ x ];
+    }  // link
+
+    // Move non-root node h with its subtree to the root list.
+    void cut( int h )
+    {
+        int p = parent[ h ];
+        if ( right[ h ] == h )
+            child[ p ] = NIL;
+        else {
+            if ( child[ p ] == h )
+                child[ p ] = right[ h ];
+            unlink( h );
+        }
+        --degree[ p ];
+        add_root( h );
+    }  // cut
+
+    // Cut the marked ancestors of h starting from h, and mark the
+    // first unmarked one.
+    void cascading_cut( int h )
+    {
+        int p;
+        while ( NIL != ( p = parent[ h ] ) ) {
+            if ( !mark[ h ] ) {
+                mark[ h ] = true;
+                return;
+            }
+            cut( h );
+            h = p;
+        }
+    }  // cascading_cut
+
+    // Remove h from the heap. Its children move to the root list.
+    void remove( int h )
+    {
+        int p = parent[ h ];
+        if ( NIL != p ) {
+            cut( h );
+            cascading_cut( p );
+        }
+
+        // h is a root now. Move its children to the root list.
+        int c = child[ h ];
+        if ( NIL != c ) {
+            int next;
+            do {
+                next = right[ c ];
+                add_root( c );
+                c = next;
+            } while ( parent[ c ] == h );
+            child[ h ] = NIL;
+            degree[ h ] = 0;
+        }
+
+        // Remove h from the root list.
+        if ( right[ h ] == h ) {
+            min_node = NIL;
+        } else {
+            int r = right[ h ];
+            unlink( h );
+            if ( min_node == h ) {
+                min_node = r;
+                consolidate();
+            }
+        }
+    }  // remove
+
+    // Link the roots with the same degree until all the roots have
+    // different degrees, and find the min root.
+    void consolidate()
+    {
+        int nroots = 0;
+        int h = min_node;
+        do {
+            roots[ nroots++ ] = h;
+            h = right[ h ];
+        } while ( h != min_node );
+
+        int by_degree[ MAX_DEGREE ];
+        init_table( by_degree, 0, MAX_DEGREE - 1, NIL );
+        for ( int i = 0; i < nroots; ++i ) {
+            int x = roots[ i ];
+            int d = degree[ x ];
+            while ( NIL != by_degree[ d ] ) {
+                int y = by_degree[ d ];
+                if ( node_key[ y ] < node_key[ x ] ) {
+                    int tmp = x;
+                    x = y;
+                    y = tmp;
+                }
+                unlink( y );
+                link( y, x );
+                by_degree[ d++ ] = NIL;
+            }
+            by_degree[ d ] = x;
+        }
+
+        min_node = NIL;
+        for ( int d = 0; d < MAX_DEGREE; ++d ) {
+            int x = by_degree[ d ];
+            if ( ( NIL != x ) &&
+                 ( ( NIL == min_node ) || ( node_key[ x ] < node_key[ min_node ] ) ) )
+                min_node = x;
+        }
+    }  // consolidate
+
+    // Resize the arrays by MAX_ALLOC_SIZE.
+    void resize()
+    {
+        int old_len = len;
+        len += MAX_ALLOC_SIZE;
+        resize_table( node_key, old_len, len );
+        resize_table( node_info, old_len, len );
+        resize_table( parent, old_len, len );
+        resize_table( child, old_len, len );
+        resize_table( left, old_len, len );
+        resize_table( right, old_len, len );
+        resize_table( degree, old_len, len );
+        resize_table( mark, old_len, len );
+        resize_table( roots, old_len, len );
+    }  // resize
+};  // ad_fib_pq
+
+#endif
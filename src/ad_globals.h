@@ -89,6 +89,34 @@ init_table( T *ptr, int from, int to, T val )
         ptr[ i ] = val;
 }
 
+// Move ptr[ i ] to ptr[ new_inx[ i ] ] for i = 0, ..., len-1, where
+// new_inx is a permutation. ptr is reallocated.
+template< class T >
+inline
+void
+permute_table( T *&ptr, const int *new_inx, int len )
+{
+    T *new_ptr = new T[ len ];
+    for ( int i = 0; i < len; ++i )
+        new_ptr[ new_inx[ i ] ] = ptr[ i ];
+    delete [] ptr;
+    ptr = new_ptr;
+}
+
+// Reallocate ptr from old_len to new_len entries, keeping the first
+// old_len entries.
+template< class T >
+inline
+void
+resize_table( T *&ptr, int old_len, int new_len )
+{
+    T *new_ptr = new T[ new_len ];
+    for ( int i = 0; i < old_len; ++i )
+        new_ptr[ i ] = ptr[ i ];
+    delete [] ptr;
+    ptr = new_ptr;
+}
+
 template< class T >
 inline
 T
@@ -126,6 +154,13 @@ typedef struct {
     int  w1, w2;  // Parameters for weights.
     int  t1, t2;  // Parameters for transit times.
     long seed;
+    int  nthreads;  // Number of threads to find and solve the SCCs with, or 0 if not given.
+    int  bin_format;  // Dump format: 0=DIMACS, 1=binary, 2=binary+adjacency.
+    int  scc_alg;     // SCC algorithm: 0=two-pass, 1=one-pass, 2=parallel.
+    char alg_names[ MAX_STR_SIZE ];  // Comma-separated solver names.
+    bool race;        // Race the solvers on each SCC rather than run each.
+    bool exact;       // Verify lambda in integers and print it exactly.
+    int  num_bits;    // Numeric policy of the solvers: 0=auto, 16, 32, 64.
 } args_t;
 
 #endif
@@ -3,7 +3,9 @@
 //
 //#include <new.h>
 #include <new>
+#include <limits.h>
 #include "ad_graph.h"
+#include "ad_cqueue.h"
 #include "ad_util.h"
 
 ///////////////////////////////////////////////////////////////////////
@@ -11,21 +13,45 @@
 ///////////////////////////////////////////////////////////////////////
 
 // Find the number of SCCs as well as a map comp_num of which node
-// belongs to which SCC.
+// belongs to which SCC, using the algorithm scc_alg.
 int 
-num_sccs( const ad_graph< ninfo >& g, int *comp_num );
+num_sccs( const ad_graph< ninfo >& g, int *comp_num, int scc_alg, int nthreads );
 
-// Traverse g in DFS order using outedges.
+// Same as num_sccs but with two DFS passes.
+int 
+num_sccs_two_pass( const ad_graph< ninfo >& g, int *comp_num );
+
+// Same as num_sccs but with one iterative DFS pass.
+int 
+num_sccs_one_pass( const ad_graph< ninfo >& g, int *comp_num );
+
+// Same as num_sccs but with trimming and forward-backward reach on
+// nthreads threads.
+int 
+num_sccs_parallel( const ad_graph< ninfo >& g, int *comp_num, int nthreads );
+
+// An entry of the stack of an iterative DFS: a node and the index of
+// its next edge to follow.
+struct dfs_stack_entry {
+    int node;
+    int edge_index;
+};
+
+// Traverse g in DFS order using outedges. stack must have room for
+// g.num_nodes() entries; it is only scratch space, so one stack serves
+// all the roots.
 void 
 traverse_via_outedges( const ad_graph< ninfo >& g, 
                        int v, bool *not_visited, 
-                       int& n, int *node_list );
+                       int& n, int *node_list,
+                       dfs_stack_entry *stack );
 
 // Traverse g in DFS order using outedges. Iterative DFS for scalability.
 void 
 traverse_via_outedges_iter( const ad_graph< ninfo >& g, 
                             int v, bool *not_visited, 
-                            int& n, int *node_list );
+                            int& n, int *node_list,
+                            dfs_stack_entry *stack );
 
 // Traverse g in DFS order using outedges. This recursive version runs
 // into stack size limitations for some large random graphs in the
@@ -35,16 +61,18 @@ traverse_via_outedges_recur( const ad_graph< ninfo >& g,
                              int v, bool *not_visited, 
                              int& n, int *node_list );
 
-// Traverse g in DFS order using inedges.
+// Traverse g in DFS order using inedges. stack is as above.
 void 
 traverse_via_inedges( const ad_graph< ninfo >& g, 
-                      int v, int num_comps, int *comp_num );
+                      int v, int num_comps, int *comp_num,
+                      dfs_stack_entry *stack );
 
 
 // Traverse g in DFS order using inedges. Iterative DFS for scalability.
 void 
 traverse_via_inedges_iter( const ad_graph< ninfo >& g, 
-                           int v, int num_comps, int *comp_num );
+                           int v, int num_comps, int *comp_num,
+                           dfs_stack_entry *stack );
 
 // Traverse g in DFS order using inedges. This recursive version runs
 // into stack size limitations for some large random graphs in the
@@ -53,19 +81,62 @@ void
 traverse_via_inedges_recur( const ad_graph< ninfo >& g, 
                             int v, int num_comps, int *comp_num );
 
-// Find the properties of SCCs before their dynamic creation.
+// Find the properties of SCCs and create a view of each SCC.
 extern 
 void
 find_component_props( ad_graph< cninfo >& cg, 
-                      const ad_graph< ninfo >& g, int *comp_num );
+                      ad_graph< ninfo >& g, int *comp_num );
 
-// Check for errors after fscanf.
-void 
-check_for_error( int status, int val );
+// Skip the blanks and the comment lines, i.e., the lines starting with
+// 'c', 't', or 'n', of a DIMACS file mapped to [p, end).
+const char *
+skip_junk( const char *p, const char *end );
+
+// Skip the blanks and then the token at p.
+const char *
+skip_token( const char *p, const char *end );
+
+// Skip the blanks and then parse the integer at p into val. Return the
+// position after the integer or NULL if there is no integer at p. An
+// integer too large for val is saturated, so the caller can reject it.
+inline
+const char *
+parse_int( const char *p, const char *end, long long& val );
 
-// Remove comments and other junk from input files in DIMACS format.
-char
-remove_junk( FILE *fp );
+// Write len ints from ptr to fp, negated if negate is true.
+void
+write_table( FILE *fp, const int *ptr, int len, bool negate = false );
+
+///////////////////////////////////////////////////////////////////////
+// Binary graph format:
+//
+// The header below is followed by the edge arrays esrc, etar, einf, and
+// einf2 (if BIN_TTIME) of m ints each. If BIN_ADJ, the inedge arrays
+// in_first (n + 1 ints), in_src, in_edge, in_inf, and in_inf2 (if
+// BIN_TTIME), and then the outedge arrays out_first, out_tar, out_edge,
+// out_inf, and out_inf2 (if BIN_TTIME) follow. The ints are in the
+// byte order of the machine that wrote the file. The weights are never
+// negated, as in DIMACS files. Version 2 widened the totals in the
+// header to 64 bits.
+
+const char BIN_MAGIC[ 8 ] = { 'A', 'D', 'G', 'R', 'A', 'P', 'H', '\0' };
+const int  BIN_VERSION = 2;
+
+// Flags.
+const int  BIN_TTIME = 1;  // The transit times are in the file.
+const int  BIN_ADJ = 2;    // The adjacency arrays are in the file.
+
+struct bin_header {
+    char magic[ 8 ];
+    int       version;
+    int       flags;
+    int       nnodes;
+    int       nedges;
+    long long total_weight;   // Sum of |w( e )| over all e.
+    long long total_ttime;    // Sum of t( e ) over all e.
+    int       has_self_loop;
+    int       unused;         // Keeps the arrays 8-byte aligned.
+};
 
 ///////////////////////////////////////////////////////////////////////
 // External I/O functions:
@@ -88,7 +159,7 @@ print( const cninfo& cni )
 }
 
 ///////////////////////////////////////////////////////////////////////
-// Build the adjacency lists of the graph.
+// Build the adjacency lists of the graph in the CSR form.
 // pre: The lists are already allocated.
 // pre: The nodes and edges are already inserted into the lists.
 template< class ninfo_t >
@@ -98,254 +169,730 @@ build_adj()
 {
 #ifdef DEBUG
     assert( nlist != NULL );
-    assert( elist != NULL );
+    assert( esrc != NULL );
 #endif
 
     // Correct num_nodes and num_edges, and prevent further updates.
     update_nums();
 
+    int n = num_nodes();
+    int m = num_edges();
+
+    // Count the degrees. The degree of v is kept in the head of v+1
+    // until the prefix sums below turn the counts into the heads.
+    for ( int v = 0; v <= n; ++v ) {
+        in_first[ v ] = 0;
+        out_first[ v ] = 0;
+    }
+    for ( int e = 0; e < m; ++e ) {
+        out_first[ esrc[ e ] + 1 ]++;
+        in_first[ etar[ e ] + 1 ]++;
+    }
+
     // Set the list heads based on the node degrees.
-    int pre_in_sum = 0;
-    int pre_out_sum = 0;
-    for ( int v = 0; v < num_nodes(); ++v ) {
-        first_inedge( v, pre_in_sum );
-        first_outedge( v, pre_out_sum );
-        pre_in_sum += indegree( v );
-        pre_out_sum += outdegree( v );
+    for ( int v = 0; v < n; ++v ) {
+        in_first[ v + 1 ] += in_first[ v ];
+        out_first[ v + 1 ] += out_first[ v ];
     }
 
-    int *in_inx = new int[ num_nodes() ];
-    int *out_inx = new int[ num_nodes() ];
+    int *in_inx = new int[ n ];
+    int *out_inx = new int[ n ];
 
     // Initialize the indices into the lists.
-    for( int v = 0; v < num_nodes(); ++v ) {
-        in_inx[ v ] = 0;
-        out_inx[ v ] = 0;
+    for( int v = 0; v < n; ++v ) {
+        in_inx[ v ] = in_first[ v ];
+        out_inx[ v ] = out_first[ v ];
     }
 
     // Insert edge e = s->t into the adjacency lists of nodes s and t.
-    for ( int e = 0; e < num_edges(); ++e )  {
-        int s = source( e );
-        int t = target( e );
-        int ei = edge_info( e );
-        int ei2 = edge_info2( e );
-
-#ifdef CYCLE_MEAN_VERSION
-        outlist[ nlist[ s ].first_outedge() + out_inx[ s ] ].set_edge( e, t, ei );
-        inlist[ nlist[ t ].first_inedge() + in_inx[ t ] ].set_edge( e, s, ei );
-
-#else
-        outlist[ nlist[ s ].first_outedge() + out_inx[ s ] ].set_edge( e, t, ei, ei2 );
-        inlist[ nlist[ t ].first_inedge() + in_inx[ t ] ].set_edge( e, s, ei, ei2 );
-#endif
+    // Only the edge numbers are scattered here; the other adjacency
+    // arrays are then filled in order, which halves the number of
+    // random writes per edge.
+    for ( int e = 0; e < m; ++e )  {
+        out_edge[ out_inx[ esrc[ e ] ]++ ] = e;
+        in_edge[ in_inx[ etar[ e ] ]++ ] = e;
+    }
 
-        out_inx[ s ]++;
-        in_inx[ t ]++;
-    }  
+    for ( int i = 0; i < m; ++i ) {
+        int e = out_edge[ i ];
+        out_tar[ i ] = etar[ e ];
+        out_inf[ i ] = einf[ e ];
+        out_inf2[ i ] = einf2[ e ];
+    }
+    for ( int i = 0; i < m; ++i ) {
+        int e = in_edge[ i ];
+        in_src[ i ] = esrc[ e ];
+        in_inf[ i ] = einf[ e ];
+        in_inf2[ i ] = einf2[ e ];
+    }
 
     delete [] out_inx;
     delete [] in_inx;
 }  // build_adj
 
-///////////////////////////////////////////////////////////////////////
-// Check for errors after fscanf.
+// Copy the edge weights and transit times from the edge arrays into
+// the adjacency arrays.
+template< class ninfo_t >
 void 
-check_for_error( int status, int val )
+ad_graph< ninfo_t >::
+sync_adj_info()
 {
-    if ( EOF == status ) {
-        printf( "ERROR: EOF is reached before all edges are read.\n" );
-        abort();
-    } else if ( status != val ) {
-        printf( "ERROR: Cannot read %d items.\n", val );
-        abort();
+    for ( int i = 0; i < num_edges(); ++i ) {
+        out_inf[ i ] = einf[ out_edge[ i ] ];
+        in_inf[ i ] = einf[ in_edge[ i ] ];
+        out_inf2[ i ] = einf2[ out_edge[ i ] ];
+        in_inf2[ i ] = einf2[ in_edge[ i ] ];
     }
-}  // check_for_error
+}  // sync_adj_info
 
-// Remove comments and other junk from input files in DIMACS format.
-char
-remove_junk( FILE *fp ) 
+///////////////////////////////////////////////////////////////////////
+// Return true if c is a blank, i.e., a space, a newline, or any other
+// control character.
+inline
+bool
+is_blank( char c )
 {
-    char buf[ MAX_LINE_SIZE ];
-    int status;
+    return ( unsigned char ) c <= ' ';
+}
 
-    status = fscanf( fp, "%s", buf );
-#ifdef DEBUG
-    check_for_error( status, 1 );
-#endif
-    while ( ( 'c' == buf[ 0 ] ) || ( 't' == buf[ 0 ] ) || ( 'n' == buf[ 0 ] ) ) {
-#ifdef DEBUG
-        char *ptr = fgets(buf, sizeof( buf ), fp);
-        if ( NULL == ptr ) {
-            printf( "ERROR: EOF is reached before all edges are read.\n" );
-            abort();
+const char *
+skip_junk( const char *p, const char *end )
+{
+    while ( p < end ) {
+        if ( is_blank( *p ) ) {
+            ++p;
+        } else if ( ( 'c' == *p ) || ( 't' == *p ) || ( 'n' == *p ) ) {
+            while ( ( p < end ) && ( '\n' != *p ) )
+                ++p;
+        } else {
+            break;
+        }
+    }
+    return p;
+}  // skip_junk
+
+const char *
+skip_token( const char *p, const char *end )
+{
+    while ( ( p < end ) && is_blank( *p ) )
+        ++p;
+    while ( ( p < end ) && !is_blank( *p ) )
+        ++p;
+    return p;
+}  // skip_token
+
+inline
+const char *
+parse_int( const char *p, const char *end, long long& val )
+{
+    while ( ( p < end ) && is_blank( *p ) )
+        ++p;
+
+    bool negative = false;
+    if ( ( p < end ) && ( ( '-' == *p ) || ( '+' == *p ) ) ) {
+        negative = ( '-' == *p );
+        ++p;
+    }
+
+    if ( ( p == end ) || ( *p < '0' ) || ( '9' < *p ) )
+        return NULL;
+
+    // Any x at or above LLONG_MAX / 10 is out of the range of int.
+    long long x = 0;
+    do {
+        if ( x < LLONG_MAX / 10 )
+            x = 10 * x + ( *p - '0' );
+        ++p;
+    } while ( ( p < end ) && ( '0' <= *p ) && ( *p <= '9' ) );
+
+    val = ( negative ? -x : x );
+    return p;
+}  // parse_int
+
+// Errors found while parsing the arc lines.
+enum {
+    READ_OK,
+    READ_NO_ARC,      // A line is not an arc line.
+    READ_NO_ITEMS,    // An arc line has fewer than 4 items.
+    READ_BAD_NODE,    // A node number is out of range.
+    READ_BAD_WEIGHT,  // A weight is out of the range of int.
+    READ_BAD_TTIME    // A transit time is not positive or too large.
+};
+
+// Files smaller than this are read by a single thread.
+const long MIN_READ_CHUNK_SIZE = ( 1 << 20 );
+
+// A line-aligned chunk of the arc lines of a DIMACS file and the arcs
+// parsed from it. The node numbers are stored starting from 0.
+struct read_chunk {
+    const char *begin;
+    const char *end;
+    int        nnodes;    // For checking the node numbers.
+    int        max_arcs;  // Parse at most this many arcs.
+    int        narcs;     // Number of arcs parsed.
+    int        error;     // Error that stopped the parse, if any.
+    int        first;     // Number of the first arc in the edge arrays.
+    int        *src, *tar, *wgt, *ttime;  // ttime may be NULL.
+};
+
+// Work shared by the threads reading the chunks.
+struct read_work {
+    read_chunk *chunks;
+    int        nchunks;
+    int        next;       // Next chunk to process.
+    int        *src, *tar, *wgt, *ttime;  // Edge arrays to merge into.
+};
+
+void
+report_read_error( int error, int e )
+{
+    switch ( error ) {
+    case READ_NO_ARC:
+        printf( "ERROR: An edge is expected.\n" );
+        break;
+    case READ_NO_ITEMS:
+        printf( "ERROR: Cannot read 4 items for edge %d.\n", e );
+        break;
+    case READ_BAD_NODE:
+        printf( "ERROR: Invalid node number.\n" );
+        break;
+    case READ_BAD_WEIGHT:
+        printf( "ERROR: The weight of edge %d is out of range.\n", e );
+        break;
+    case READ_BAD_TTIME:
+        printf( "ERROR: Transit time must be a positive integer.\n" );
+        break;
+    }
+}  // report_read_error
+
+// Parse the arc lines of a chunk until its end, an error, or max_arcs
+// arcs.
+void
+parse_chunk( read_chunk& ch )
+{
+    const char *p = ch.begin;
+    const char *end = ch.end;
+
+    // Edge (u, v) with weight w and transit time t. An SCC whose
+    // transit times are all 1 is solved as a cycle mean problem.
+    long long u, v, w, t;
+
+    while ( ch.narcs < ch.max_arcs ) {
+        p = skip_junk( p, end );
+        if ( p == end )
+            break;
+
+        if ( 'a' != *p ) {
+            ch.error = READ_NO_ARC;
+            break;
+        }
+
+        p = skip_token( p, end );
+        if ( ( NULL == ( p = parse_int( p, end, u ) ) ) ||
+             ( NULL == ( p = parse_int( p, end, v ) ) ) ||
+             ( NULL == ( p = parse_int( p, end, w ) ) ) ||
+             ( NULL == ( p = parse_int( p, end, t ) ) ) ) {
+            ch.error = READ_NO_ITEMS;
+            break;
+        }
+
+        if ( ( u < 1 || u > ch.nnodes ) || ( v < 1 || v > ch.nnodes ) )  {
+            ch.error = READ_BAD_NODE;
+            break;
+        }
+
+        if ( !is_weight_valid( w ) ) {
+            ch.error = READ_BAD_WEIGHT;
+            break;
+        }
+
+        int e = ch.narcs++;
+        ch.src[ e ] = ( int ) u - 1;
+        ch.tar[ e ] = ( int ) v - 1;
+        ch.wgt[ e ] = ( int ) w;
+
+        if ( ch.ttime ) {
+            if ( ( t < 1 ) || ( INT_MAX < t ) ) {
+                --ch.narcs;
+                ch.error = READ_BAD_TTIME;
+                break;
+            }
+            ch.ttime[ e ] = ( int ) t;
         }
-#else
-        ( void ) fgets(buf, sizeof( buf ), fp);
-#endif
-        status = fscanf( fp, "%s", buf );
-#ifdef DEBUG
-        check_for_error( status, 1 );
-#endif
     }  // while
+}  // parse_chunk
 
-    return buf[ 0 ];
-}
+void *
+parse_chunks( void *arg )
+{
+    read_work *w = ( read_work * ) arg;
+
+    while ( true ) {
+        int c = __atomic_fetch_add( &w->next, 1, __ATOMIC_RELAXED );
+        if ( c >= w->nchunks )
+            break;
+        parse_chunk( w->chunks[ c ] );
+    }
+    return NULL;
+}  // parse_chunks
+
+void *
+merge_chunks( void *arg )
+{
+    read_work *w = ( read_work * ) arg;
+
+    while ( true ) {
+        int c = __atomic_fetch_add( &w->next, 1, __ATOMIC_RELAXED );
+        if ( c >= w->nchunks )
+            break;
+
+        const read_chunk& ch = w->chunks[ c ];
+        size_t len = ch.narcs * sizeof( int );
+        memcpy( w->src + ch.first, ch.src, len );
+        memcpy( w->tar + ch.first, ch.tar, len );
+        memcpy( w->wgt + ch.first, ch.wgt, len );
+        if ( w->ttime )
+            memcpy( w->ttime + ch.first, ch.ttime, len );
+    }
+    return NULL;
+}  // merge_chunks
 
-// Read the graph from file input_file. Duplicate edges are removed.
+// Read the graph from file input_file. The file is mapped into memory
+// and its arc lines are parsed, and validated, by args.nthreads threads
+// in one pass. The arcs keep their order in the file. Duplicate edges
+// are not removed.
 template< class ninfo_t >
-void
+bool
 ad_graph< ninfo_t >::
 read( ginfo& gi, const args_t& args )
 {
-    FILE *fp;
-
-    if ( ( fp = fopen( args.input_file, "r" ) ) == NULL ) {
-        printf( "ERROR: Cannot open the input file %s.\n", args.input_file );
-        abort();
-    }
+    size_t size;
+    char *data = map_file( args.input_file, size );
+    if ( NULL == data )
+        return false;
+    const char *end = data + size;
 
-    char buf[ MAX_LINE_SIZE ];
-#ifdef CYCLE_MEAN_VERSION
-    int  status, total_weight = 0; // of the edges
-#else
-    int  status, total_weight = 0, total_ttime = 0; // of the edges
-#endif
-    bool has_self_loop = false;
+    if ( ( sizeof( bin_header ) <= size ) && !memcmp( data, BIN_MAGIC, sizeof( BIN_MAGIC ) ) )
+        return read_binary( gi, args, data, size );
 
-    buf[ 0 ] = remove_junk( fp );
+    const char *p = skip_junk( data, end );
+    long long n, m;
 
     // Read the problem line, the line starting with 'p'.
-    if ( 'p' != buf[ 0 ] ) {
+    if ( ( p == end ) || ( 'p' != *p ) ) {
         printf( "ERROR: Input file %s is not in DIMACS format.\n", args.input_file );
-        abort();
+        unmap_file( data, size );
+        return false;
     }
 
-    // Read the rest of the line after the line descriptor. This line
-    // assumes that the problem name will not overflow buf.
-    status = fscanf( fp, "%s%d%d", buf, &nnodes, &nedges );
-#ifdef DEBUG
-    check_for_error( status, 3 );
-#endif
-
-    if ( ( nnodes <= 0 ) || ( nedges < 0 ) ) {
-        printf( "ERROR: Require 'nnodes > 0' and 'nedges >= 0'. \n" );
-        abort();
+    // Skip the line descriptor and the problem name.
+    p = skip_token( skip_token( p, end ), end );
+    if ( ( NULL == ( p = parse_int( p, end, n ) ) ) ||
+         ( NULL == ( p = parse_int( p, end, m ) ) ) ) {
+        printf( "ERROR: Cannot read the problem line of %s.\n", args.input_file );
+        unmap_file( data, size );
+        return false;
     }
-  
-    if ( nedges ) {
-        buf[ 0 ] = remove_junk( fp );
 
-        if ( 'a' != buf[ 0 ] ) {
-            printf( "ERROR: Input file %s is not in DIMACS format.\n", args.input_file );
-            abort();
-        }
+    if ( ( n <= 0 ) || ( m < 0 ) || ( INT_MAX < n ) || ( INT_MAX < m ) ) {
+        printf( "ERROR: Require 'nnodes > 0' and 'nedges >= 0', both ints. \n" );
+        unmap_file( data, size );
+        return false;
     }
+    nnodes = ( int ) n;
+    nedges = ( int ) m;
 
     // Create node, edge, and adj lists.
     create( nnodes, nedges );
 
-    // Edge (u, v) with weight w and transit time t. The transit time is
-    // ignored for the cycle mean problems.
-    int u, v, w, t; 
+    // Split the arc lines into line-aligned chunks, one per thread, and
+    // parse the chunks in parallel. Chunk 0 is parsed straight into the
+    // edge arrays; the others are parsed into their own buffers.
+    long len = end - p;
+    int nchunks = ( int ) min( ( long ) max( 1, args.nthreads ), 1 + len / MIN_READ_CHUNK_SIZE );
+    read_chunk *chunks = new read_chunk[ nchunks ];
 
-    if ( nedges ) {
-        // Read the rest of the line for edge if buf[0] is 'a'.
-        status = fscanf( fp, "%d%d%d%d", &u, &v, &w, &t );
-#ifdef DEBUG
-        check_for_error( status, 4 );
-#endif
-    }
+    for ( int c = 0; c < nchunks; ++c ) {
+        read_chunk& ch = chunks[ c ];
 
-    // Read the edges. If the file doesn't contain nedges lines, we will
-    // have an error after the following fscanf.
-    for ( int e = 0; e < nedges; ++e ) {
-#ifdef DEBUG
-        if ( ( u < 1 || u > nnodes ) || ( v < 1 || v > nnodes ) )  {
-            printf( "ERROR: Invalid node number.\n" );
-            abort();
+        if ( 0 == c ) {
+            ch.begin = p;
+        } else {
+            const char *q = max( p + ( len * c ) / nchunks, chunks[ c - 1 ].begin );
+            while ( ( q < end ) && ( '\n' != q[ -1 ] ) )
+                ++q;
+            ch.begin = q;
+            chunks[ c - 1 ].end = q;
         }
-#endif
+        ch.end = end;
+        ch.nnodes = nnodes;
+        ch.narcs = 0;
+        ch.error = READ_OK;
+    }
 
-        if ( 0 == args.mode ) {
-            w -= args.offset;
+    for ( int c = 0; c < nchunks; ++c ) {
+        read_chunk& ch = chunks[ c ];
+
+        if ( 0 == c ) {
+            ch.max_arcs = nedges;
+            ch.src = esrc;
+            ch.tar = etar;
+            ch.wgt = einf;
+            ch.ttime = einf2;
         } else {
-            w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
+            // An arc line has at least 9 characters and a newline.
+            ch.max_arcs = ( int ) min( ( long ) nedges, 1 + ( ch.end - ch.begin ) / 10 );
+            ch.src = new int[ ch.max_arcs ];
+            ch.tar = new int[ ch.max_arcs ];
+            ch.wgt = new int[ ch.max_arcs ];
+            ch.ttime = new int[ ch.max_arcs ];
         }
+    }
 
-        total_weight += abs_val( w );
-#ifdef DEBUG
-        assert( 0 <= total_weight );
-#endif
+    read_work w;
+    w.chunks = chunks;
+    w.nchunks = nchunks;
+    w.next = 0;
+    run_threads( nchunks, parse_chunks, &w );
+
+    // Find where each chunk goes in the edge arrays. The arcs after the
+    // first nedges ones are ignored as in a serial read, so are their
+    // errors.
+    int nread = 0;
+    int nused = 0;
+    int error = READ_OK;
+    for ( int c = 0; ( c < nchunks ) && ( nread < nedges ) && ( READ_OK == error ); ++c ) {
+        read_chunk& ch = chunks[ c ];
+
+        ch.first = nread;
+        if ( ch.narcs >= nedges - nread ) {
+            ch.narcs = nedges - nread;
+        } else if ( READ_OK != ch.error ) {
+            error = ch.error;
+            report_read_error( error, nread + ch.narcs + 1 );
+        }
+        nread += ch.narcs;
+        nused = c + 1;
+    }
 
-#ifndef CYCLE_MEAN_VERSION
-        total_ttime += t;
-#ifdef DEBUG
-        assert( 0 <= total_ttime );
+    if ( ( READ_OK == error ) && ( nread < nedges ) ) {
+        printf( "ERROR: EOF is reached before all edges are read.\n" );
+        error = READ_NO_ITEMS;
+    }
 
-        if ( t < 1 ) {
-            printf(" ERROR: Transit time must be a positive integer.\n");
-            abort();
-        }
-#endif
-#endif
+    // Move the arcs of the other chunks into the edge arrays.
+    if ( READ_OK == error ) {
+        w.nchunks = nused;
+        w.next = 1;
+        w.src = esrc;
+        w.tar = etar;
+        w.wgt = einf;
+        w.ttime = einf2;
+        run_threads( nused - 1, merge_chunks, &w );
+    }
 
-        --u;
-        --v;
+    for ( int c = 1; c < nchunks; ++c ) {
+        delete [] chunks[ c ].src;
+        delete [] chunks[ c ].tar;
+        delete [] chunks[ c ].wgt;
+        delete [] chunks[ c ].ttime;
+    }
+    delete [] chunks;
 
-        if ( u == v )
-            has_self_loop = true;
+    unmap_file( data, size );
 
-#ifdef CYCLE_MEAN_VERSION
-        if ( args.min_version )
-            ins_edge( u, v, w );
-        else 
-            ins_edge( u, v, -w );
+    if ( READ_OK != error )
+        return false;
 
-#else
-        if ( args.min_version )
-            ins_edge( u, v, w, t );
-        else 
-            ins_edge( u, v, -w, t );
-#endif
+    cur_edge = nedges - 1;
 
+    if ( !set_weights( gi, args ) ) {
+        printf( "ERROR: An edge weight is out of range after the offset.\n" );
+        return false;
+    }
+    build_adj();
 
-        if ( e == nedges - 1 )
-            break;
+    return true;
+}  // read
+
+template< class ninfo_t >
+bool
+ad_graph< ninfo_t >::
+build( ginfo& gi, const args_t& args, int n, int m, 
+       const int *src, const int *tar, const int *wgt, const int *ttime )
+{
+    for ( int e = 0; e < m; ++e ) {
+        if ( ( src[ e ] < 0 ) || ( n <= src[ e ] ) || ( tar[ e ] < 0 ) || ( n <= tar[ e ] ) )
+            return false;
+    }
+
+    clear();
+    create( n, m );
+
+    memcpy( esrc, src, m * sizeof( int ) );
+    memcpy( etar, tar, m * sizeof( int ) );
+    memcpy( einf, wgt, m * sizeof( int ) );
+    if ( ttime )
+        memcpy( einf2, ttime, m * sizeof( int ) );
+    else
+        init_table( einf2, 0, m - 1, 1 );
+    cur_edge = m - 1;
 
-        status = fscanf( fp, "%s%d%d%d%d", buf, &u, &v, &w, &t );
+    if ( !set_weights( gi, args ) )
+        return false;
+    build_adj();
+
+    return true;
+}  // build
+
+// Set the weights in file order so that the weights generated in mode 1
+// do not depend on the number of threads.
+template< class ninfo_t >
+bool
+ad_graph< ninfo_t >::
+set_weights( ginfo& gi, const args_t& args )
+{
+    long long total_weight = 0, total_ttime = 0; // of the edges
+    bool      has_self_loop = false;
+
+    for ( int e = 0; e < nedges; ++e ) {
+        long long w = einf[ e ];
+
+        if ( 0 == args.mode ) {
+            w -= args.offset;
+        } else {
+            w = ( long long ) ( *dist_func )( args.w1, args.w2 ) - args.offset;
+        }
+
+        if ( !is_weight_valid( w ) )
+            return false;
+
+        total_weight += abs_val( w );
 #ifdef DEBUG
-        check_for_error( status, 5 );
+        assert( 0 <= total_weight );
 #endif
 
-        if ( 'a' != buf[ 0 ] ) {
+        total_ttime += einf2[ e ];
 #ifdef DEBUG
-            printf( "ERROR: An edge is expected.\n" );
-            abort();
+        assert( 0 <= total_ttime );
 #endif
-        }
-    }  // for each e, read e.
-
-    fclose( fp );
 
-    build_adj();
+        if ( esrc[ e ] == etar[ e ] )
+            has_self_loop = true;
 
-#ifdef CYCLE_MEAN_VERSION
-    // total_weight = 2 + |w( e )| for all e.
-    gi.total_edge_weight = 2 + total_weight;
-    gi.has_self_loop = has_self_loop;
+        einf[ e ] = ( int ) ( args.min_version ? w : -w );
+    }  // for each e
 
-#else
     // total_weight = 2 + |w( e )| for all e.
     gi.total_edge_weight = 2 + total_weight;
     gi.total_trans_time = total_ttime;
     gi.has_self_loop = has_self_loop;
-#endif
 
 #ifdef DEBUG
     assert( total_weight < gi.total_edge_weight );
     assert( 0 <= gi.total_edge_weight );
 #endif
-}  // read
+
+    return true;
+}  // set_weights
+
+// Return true if first, node, and edge can be the adjacency arrays of
+// a graph with n nodes and m edges: the list of node v is edge[
+// first[ v ] ], ..., edge[ first[ v + 1 ] - 1 ], the lists cover the m
+// entries in order, and every node and edge is in range, so using the
+// arrays stays in bounds. If inf is not NULL, every inf is also a valid
+// weight and every inf2 a positive transit time. Whether the lists
+// match the edge arrays is not checked, since that takes random
+// accesses that cost as much as build_adj() does.
+bool
+is_adj_valid( int n, int m, const int *first, const int *node, const int *edge,
+              const int *inf, const int *inf2 )
+{
+    if ( ( 0 != first[ 0 ] ) || ( m != first[ n ] ) )
+        return false;
+
+    for ( int v = 0; v < n; ++v ) {
+        if ( first[ v + 1 ] < first[ v ] )
+            return false;
+    }
+
+    for ( int i = 0; i < m; ++i ) {
+        if ( ( node[ i ] < 0 ) || ( n <= node[ i ] ) || ( edge[ i ] < 0 ) || ( m <= edge[ i ] ) )
+            return false;
+        if ( inf && ( !is_weight_valid( inf[ i ] ) || ( inf2[ i ] < 1 ) ) )
+            return false;
+    }
+    return true;
+}  // is_adj_valid
+
+// Load the graph from a binary file mapped to data. The arrays in the
+// file are used in place, so loading needs no parsing and, if the
+// adjacency arrays are in the file, no build_adj. The mapping is
+// private, so the arrays can be changed, e.g., by set_weights. The
+// arrays are checked as read() checks the arc lines, and the totals in
+// the header against the edge arrays, since a file may be corrupt.
+template< class ninfo_t >
+bool
+ad_graph< ninfo_t >::
+read_binary( ginfo& gi, const args_t& args, char *data, size_t size )
+{
+    const bin_header *h = ( const bin_header * ) data;
+
+    if ( BIN_VERSION != h->version ) {
+        printf( "ERROR: Binary graph file %s has version %d, not %d.\n", 
+                args.input_file, h->version, BIN_VERSION );
+        unmap_file( data, size );
+        return false;
+    }
+
+    int  n = h->nnodes;
+    int  m = h->nedges;
+    bool has_ttime = ( 0 != ( h->flags & BIN_TTIME ) );
+    bool has_adj = ( 0 != ( h->flags & BIN_ADJ ) );
+
+    if ( ( n <= 0 ) || ( m < 0 ) ) {
+        printf( "ERROR: Require 'nnodes > 0' and 'nedges >= 0'. \n" );
+        unmap_file( data, size );
+        return false;
+    }
+
+    // The number of ints after the header.
+    size_t nints = ( has_ttime ? 4 : 3 ) * ( size_t ) m;
+    if ( has_adj )
+        nints += 2 * ( ( n + 1 ) + ( has_ttime ? 4 : 3 ) * ( size_t ) m );
+
+    if ( size != sizeof( bin_header ) + nints * sizeof( int ) ) {
+        printf( "ERROR: Binary graph file %s is truncated or corrupt.\n", args.input_file );
+        unmap_file( data, size );
+        return false;
+    }
+
+    // From here on, the graph owns data, and frees it when cleared.
+    create( 0, 0 );
+    nnodes = n;
+    nedges = m;
+    cur_node = n - 1;
+    cur_edge = m - 1;
+    mapped = data;
+    mapped_size = size;
+
+    alloc_lists( true, false );
+
+    int *ptr = ( int * ) ( data + sizeof( bin_header ) );
+
+    esrc = ptr;
+    ptr += m;
+    etar = ptr;
+    ptr += m;
+    einf = ptr;
+    ptr += m;
+    if ( has_ttime ) {
+        einf2 = ptr;
+        ptr += m;
+    } else {
+        einf2 = new int[ m ];
+        for ( int e = 0; e < m; ++e )
+            einf2[ e ] = 1;
+    }
+
+    long long total_weight = 0, total_ttime = 0;
+    bool      has_self_loop = false;
+    for ( int e = 0; e < m; ++e ) {
+        int error = READ_OK;
+        if ( ( esrc[ e ] < 0 || esrc[ e ] >= n ) || ( etar[ e ] < 0 || etar[ e ] >= n ) )
+            error = READ_BAD_NODE;
+        else if ( !is_weight_valid( einf[ e ] ) )
+            error = READ_BAD_WEIGHT;
+        else if ( einf2[ e ] < 1 )
+            error = READ_BAD_TTIME;
+        if ( READ_OK != error ) {
+            report_read_error( error, e + 1 );
+            return false;
+        }
+
+        total_weight += abs_val( ( long long ) einf[ e ] );
+        total_ttime += einf2[ e ];
+        if ( esrc[ e ] == etar[ e ] )
+            has_self_loop = true;
+    }
+
+    if ( ( total_weight != h->total_weight ) ||
+         ( has_ttime && ( total_ttime != h->total_ttime ) ) ||
+         ( has_self_loop != ( 0 != h->has_self_loop ) ) ) {
+        printf( "ERROR: Binary graph file %s is truncated or corrupt.\n", args.input_file );
+        return false;
+    }
+
+    // The weights in the file are final only in mode 0 with no offset
+    // for the min version.
+    bool same_weights = ( ( 0 == args.mode ) && ( 0 == args.offset ) && args.min_version );
+
+    if ( same_weights ) {
+        gi.total_edge_weight = 2 + total_weight;
+        gi.total_trans_time = total_ttime;
+        gi.has_self_loop = has_self_loop;
+    } else if ( !set_weights( gi, args ) ) {
+        printf( "ERROR: An edge weight is out of range after the offset.\n" );
+        return false;
+    }
+
+    if ( !has_adj ) {
+        alloc_adj();
+        build_adj();
+        return true;
+    }
+
+    in_first = ptr;
+    ptr += n + 1;
+    in_src = ptr;
+    ptr += m;
+    in_edge = ptr;
+    ptr += m;
+    in_inf = ptr;
+    ptr += m;
+    if ( has_ttime ) {
+        in_inf2 = ptr;
+        ptr += m;
+    } else {
+        in_inf2 = new int[ m ];
+    }
+
+    out_first = ptr;
+    ptr += n + 1;
+    out_tar = ptr;
+    ptr += m;
+    out_edge = ptr;
+    ptr += m;
+    out_inf = ptr;
+    ptr += m;
+    if ( has_ttime ) {
+        out_inf2 = ptr;
+        ptr += m;
+    } else {
+        out_inf2 = new int[ m ];
+    }
+
+    // The weights in the adjacency arrays are checked only if they are
+    // used as they are, i.e., not set by sync_adj_info below.
+    bool sync = ( !same_weights || !has_ttime );
+
+    bool valid = ( is_adj_valid( n, m, in_first, in_src, in_edge,
+                                 ( sync ? NULL : in_inf ), in_inf2 ) &&
+                   is_adj_valid( n, m, out_first, out_tar, out_edge,
+                                 ( sync ? NULL : out_inf ), out_inf2 ) );
+
+    if ( !valid ) {
+        printf( "ERROR: Binary graph file %s is truncated or corrupt.\n", args.input_file );
+        return false;
+    }
+
+    update_nums();
+
+    if ( sync )
+        sync_adj_info();
+
+    return true;
+}  // read_binary
 
 // Generate the given graph's weights with a given distribution.
 template< class ninfo_t >
@@ -357,19 +904,14 @@ generate_part( ginfo& gi, const args_t& args )
         int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
         int t = ( *dist_func )( args.t1, args.t2 );
 
-#ifdef CYCLE_MEAN_VERSION
-        if ( args.min_version )
-            edge_info( e, w );
-        else 
-            edge_info( e, -w );
-
-#else
         if ( args.min_version )
             edge_info( e, w, t );
         else 
             edge_info( e, -w, t );
-#endif
     }
+
+    // The adjacency arrays carry their own copies of the edge info.
+    sync_adj_info();
 }  // generate_part
 
 // Generate an entire graph with a given distribution.
@@ -387,12 +929,8 @@ generate_all( ginfo& gi, const args_t& args )
         int next_inx;
     } *tedges;
 
-#ifdef CYCLE_MEAN_VERSION
-    int  total_weight = 0;  // of the edges.
-#else
-    int  total_weight = 0, total_ttime = 0;  // of the edges.
-#endif
-    bool has_self_loop = false;
+    long long total_weight = 0, total_ttime = 0;  // of the edges.
+    bool      has_self_loop = false;
   
     nnodes = args.nnodes;
     nedges = args.nedges;
@@ -426,35 +964,20 @@ generate_all( ginfo& gi, const args_t& args )
         for ( int u = 0; u < ( nnodes - 1 ); ++u ) {
             int v = u + 1;
 
-#ifdef CYCLE_MEAN_VERSION
             int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
+            int t = ( *dist_func )( args.t1, args.t2 );
 
             total_weight += abs_val( w );
+            total_ttime += t;
 #ifdef DEBUG
             assert( 0 <= total_weight );
+            assert( 0 <= total_ttime );
 #endif
 
             if ( args.min_version )
-                ins_edge( u, v, w );
+                ins_edge( u, v, w, t );
             else 
-                ins_edge( u, v, -w );
-
-#else
-            int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
-            int t = ( *dist_func )( args.t1, args.t2 );
-
-            total_weight += abs_val( w );
-            total_ttime += t;
-#ifdef DEBUG
-            assert( 0 <= total_weight );
-            assert( 0 <= total_ttime );
-#endif
-
-            if ( args.min_version )
-                ins_edge( u, v, w, t );
-            else 
-                ins_edge( u, v, -w, t );
-#endif
+                ins_edge( u, v, -w, t );
 
             tnodes[ u ].out_deg++;
             tedges[ e ].src = u;
@@ -464,21 +987,6 @@ generate_all( ginfo& gi, const args_t& args )
             ++e;
         }
 
-#ifdef CYCLE_MEAN_VERSION
-        int u = nnodes - 1;
-        int v = 0;
-        int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
-        total_weight += abs_val( w );
-#ifdef DEBUG
-        assert( 0 <= total_weight );
-#endif
-
-        if ( args.min_version )
-            ins_edge( u, v, w );
-        else 
-            ins_edge( u, v, -w );
-
-#else
         int u = nnodes - 1;
         int v = 0;
         int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
@@ -495,7 +1003,6 @@ generate_all( ginfo& gi, const args_t& args )
             ins_edge( u, v, w, t );
         else 
             ins_edge( u, v, -w, t );
-#endif
     
         tnodes[ u ].out_deg++;
         tedges[ e ].src = u;
@@ -528,20 +1035,6 @@ generate_all( ginfo& gi, const args_t& args )
         tedges[ e ].next_inx = tnodes[ u ].out_inx;
         tnodes[ u ].out_inx = e;
 
-#ifdef CYCLE_MEAN_VERSION
-        int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
-
-        total_weight += abs_val( w );
-#ifdef DEBUG
-        assert( 0 <= total_weight );
-#endif
-
-        if ( args.min_version )
-            ins_edge( u, v, w );
-        else 
-            ins_edge( u, v, -w );
-
-#else
         int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
         int t = ( *dist_func )( args.t1, args.t2 );
 
@@ -556,7 +1049,6 @@ generate_all( ginfo& gi, const args_t& args )
             ins_edge( u, v, w, t );
         else 
             ins_edge( u, v, -w, t );
-#endif
     }
 
     delete [] tnodes;
@@ -564,17 +1056,10 @@ generate_all( ginfo& gi, const args_t& args )
 
     build_adj();
 
-#ifdef CYCLE_MEAN_VERSION
-    // total_weight = 2 + |w( e )| for all e.
-    gi.total_edge_weight = 2 + total_weight;
-    gi.has_self_loop = has_self_loop;
-
-#else
     // total_weight = 2 + |w( e )| for all e.
     gi.total_edge_weight = 2 + total_weight;
     gi.total_trans_time = total_ttime;
     gi.has_self_loop = has_self_loop;
-#endif
 
 #ifdef DEBUG
     assert( total_weight < gi.total_edge_weight );
@@ -594,9 +1079,8 @@ print( bool all_out ) const
 
     printf( "Edges:\n" );
     for ( int e = 0; e < num_edges(); ++e ) {
-        printf( "EDGE %d : %d -> %d : w = ", e, source( e ), target( e )  );
-        elist[ e ].print_info();
-        printf( "\n" );
+        printf( "EDGE %d : %d -> %d : w = %d %d\n", e, source( e ), target( e ), 
+                edge_info( e ), edge_info2( e ) );
     }
 
     if ( !all_out )
@@ -635,20 +1119,99 @@ fprint( const args_t& args ) const
         abort();
     }
 
+    if ( args.bin_format ) {
+        fprint_binary( fp, args );
+        fclose( fp );
+        return;
+    }
+
     fprintf( fp, "p generated-%ld %d %d\n", args.seed, num_nodes(), num_edges() );
     for ( int e = 0; e < num_edges(); ++e ) {
-#ifdef CYCLE_MEAN_VERSION
-        fprintf( fp, "a %d %d %d 1\n", 1 + source( e ), 1 + target( e ), edge_info( e ) );
-
-#else
+        int w = ( args.min_version ? edge_info( e ) : -edge_info( e ) );
         fprintf( fp, "a %d %d %d %d\n", 1 + source( e ), 1 + target( e ), 
-                 edge_info( e ), edge_info2( e ) );
-#endif
+                 w, edge_info2( e ) );
     }
 
     fclose( fp );
 }  // fprint
 
+void
+write_table( FILE *fp, const int *ptr, int len, bool negate )
+{
+    const int BUF_SIZE = 4096;
+    int buf[ BUF_SIZE ];
+
+    for ( int i = 0; i < len; i += BUF_SIZE ) {
+        int k = min( BUF_SIZE, len - i );
+        const int *from = ptr + i;
+
+        if ( negate ) {
+            for ( int j = 0; j < k; ++j )
+                buf[ j ] = -ptr[ i + j ];
+            from = buf;
+        }
+
+        if ( fwrite( from, sizeof( int ), k, fp ) != ( size_t ) k ) {
+            printf( "ERROR: Cannot write the output file. Abort. \n" );
+            abort();
+        }
+    }
+}  // write_table
+
+// Write the graph in the binary format, with the adjacency arrays if
+// args.bin_format is 2.
+template< class ninfo_t >
+void
+ad_graph< ninfo_t >::
+fprint_binary( FILE *fp, const args_t& args ) const
+{
+    bool negate = !args.min_version;
+    bool with_adj = ( 2 == args.bin_format );
+
+    bin_header h;
+    memset( &h, 0, sizeof( h ) );
+    memcpy( h.magic, BIN_MAGIC, sizeof( BIN_MAGIC ) );
+    h.version = BIN_VERSION;
+    h.flags = BIN_TTIME | ( with_adj ? BIN_ADJ : 0 );
+    h.nnodes = nnodes;
+    h.nedges = nedges;
+    for ( int e = 0; e < nedges; ++e ) {
+        h.total_weight += abs_val( einf[ e ] );
+        h.total_ttime += einf2[ e ];
+        if ( esrc[ e ] == etar[ e ] )
+            h.has_self_loop = 1;
+    }
+
+    if ( fwrite( &h, sizeof( h ), 1, fp ) != 1 ) {
+        printf( "ERROR: Cannot write the output file. Abort. \n" );
+        abort();
+    }
+
+    write_table( fp, esrc, nedges );
+    write_table( fp, etar, nedges );
+    write_table( fp, einf, nedges, negate );
+    write_table( fp, einf2, nedges );
+
+    if ( !with_adj )
+        return;
+
+#ifdef DEBUG
+    assert( !not_already_built );
+#endif
+
+    write_table( fp, in_first, nnodes + 1 );
+    write_table( fp, in_src, nedges );
+    write_table( fp, in_edge, nedges );
+    write_table( fp, in_inf, nedges, negate );
+    write_table( fp, in_inf2, nedges );
+
+    write_table( fp, out_first, nnodes + 1 );
+    write_table( fp, out_tar, nedges );
+    write_table( fp, out_edge, nedges );
+    write_table( fp, out_inf, nedges, negate );
+    write_table( fp, out_inf2, nedges );
+}  // fprint_binary
+
 ///////////////////////////////////////////////////////////////////////
 
 // Remove duplicate edges and print graph.
@@ -706,6 +1269,191 @@ print_no_duplicates( bool min_version )
 
 ///////////////////////////////////////////////////////////////////////
 
+template< class ninfo_t >
+void
+ad_graph< ninfo_t >::
+permute_edges( int *&ptr, const int *new_edge )
+{
+    int *new_ptr = new int[ nedges ];
+    for ( int e = 0; e < nedges; ++e )
+        new_ptr[ new_edge[ e ] ] = ptr[ e ];
+    free_table( ptr );
+    ptr = new_ptr;
+}  // permute_edges
+
+// Renumber the nodes and edges of the graph by components. See
+// ad_graph.h for the details.
+template< class ninfo_t >
+void
+ad_graph< ninfo_t >::
+sort_by_components( const int *comp_num, int ncomps, 
+                    int *node_first, int *edge_first )
+{
+    int n = num_nodes();
+    int m = num_edges();
+
+    // Count the nodes and the inside edges of each component.
+    for ( int k = 0; k <= ncomps; ++k ) {
+        node_first[ k ] = 0;
+        edge_first[ k ] = 0;
+    }
+    for ( int v = 0; v < n; ++v )
+        node_first[ comp_num[ v ] + 1 ]++;
+    for ( int e = 0; e < m; ++e ) {
+        int k = comp_num[ esrc[ e ] ];
+        if ( k == comp_num[ etar[ e ] ] )
+            edge_first[ k + 1 ]++;
+    }
+    for ( int k = 0; k < ncomps; ++k ) {
+        node_first[ k + 1 ] += node_first[ k ];
+        edge_first[ k + 1 ] += edge_first[ k ];
+    }
+
+    delete [] in_split;
+    delete [] out_split;
+    in_split = out_split = NULL;
+
+    // A single component needs no renumbering, and the adjacency lists
+    // have no edges to other components.
+    if ( 1 == ncomps )
+        return;
+
+    // Find the new number of each node and edge.
+    int *new_node = new int[ n ];
+    int *new_edge = new int[ m ];
+    {
+        int *next = new int[ ncomps ];
+
+        for ( int k = 0; k < ncomps; ++k )
+            next[ k ] = node_first[ k ];
+        for ( int v = 0; v < n; ++v )
+            new_node[ v ] = next[ comp_num[ v ] ]++;
+
+        for ( int k = 0; k < ncomps; ++k )
+            next[ k ] = edge_first[ k ];
+        int next_cross = edge_first[ ncomps ];
+        for ( int e = 0; e < m; ++e ) {
+            int k = comp_num[ esrc[ e ] ];
+            if ( k == comp_num[ etar[ e ] ] )
+                new_edge[ e ] = next[ k ]++;
+            else
+                new_edge[ e ] = next_cross++;
+        }
+
+        delete [] next;
+    }
+
+    // Keep the numbers before renumbering.
+    if ( NULL == node_orig ) {
+        node_orig = new int[ n ];
+        for ( int v = 0; v < n; ++v )
+            node_orig[ v ] = v;
+    }
+    if ( NULL == edge_orig ) {
+        edge_orig = new int[ m ];
+        for ( int e = 0; e < m; ++e )
+            edge_orig[ e ] = e;
+    }
+
+    // Move the nodes and edges to their new places. Only one extra
+    // array is allocated at a time.
+    permute_table( nlist, new_node, n );
+    permute_table( node_orig, new_node, n );
+    permute_table( edge_orig, new_edge, m );
+    permute_edges( esrc, new_edge );
+    permute_edges( etar, new_edge );
+    permute_edges( einf, new_edge );
+    permute_edges( einf2, new_edge );
+    for ( int e = 0; e < m; ++e ) {
+        esrc[ e ] = new_node[ esrc[ e ] ];
+        etar[ e ] = new_node[ etar[ e ] ];
+    }
+
+    delete [] new_edge;
+    delete [] new_node;
+
+    // Rebuild the adjacency lists. Since the inside edges are numbered
+    // before the edges between components, they come first in every
+    // list.
+    build_adj();
+
+    int cross_first = edge_first[ ncomps ];
+    in_split = new int[ n ];
+    out_split = new int[ n ];
+    for ( int v = 0; v < n; ++v ) {
+        int i = in_first[ v ];
+        while ( ( i < in_first[ v + 1 ] ) && ( in_edge[ i ] < cross_first ) )
+            ++i;
+        in_split[ v ] = i;
+
+        i = out_first[ v ];
+        while ( ( i < out_first[ v + 1 ] ) && ( out_edge[ i ] < cross_first ) )
+            ++i;
+        out_split[ v ] = i;
+    }
+}  // sort_by_components
+
+///////////////////////////////////////////////////////////////////////
+
+// Regenerate the edge weights of the SCC with a given distribution.
+void    
+ad_scc_view::
+generate_part( ginfo& gi, const args_t& args )
+{
+    for ( int e = efirst; e < efirst + nedges; ++e ) {
+        int w = ( *dist_func )( args.w1, args.w2 ) - args.offset;
+        int t = ( *dist_func )( args.t1, args.t2 );
+
+        einf[ e ] = ( args.min_version ? w : -w );
+        einf2[ e ] = t;
+    }
+
+    // The adjacency arrays of the graph carry their own copies of the
+    // edge info. Only the edges inside the SCC have changed.
+    for ( int v = shift + delta; v < nnodes + delta; ++v ) {
+        for ( int i = in_first[ v ]; i < in_split[ v ]; ++i ) {
+            in_inf[ i ] = einf[ in_edge[ i ] ];
+            in_inf2[ i ] = einf2[ in_edge[ i ] ];
+        }
+        for ( int i = out_first[ v ]; i < out_split[ v ]; ++i ) {
+            out_inf[ i ] = einf[ out_edge[ i ] ];
+            out_inf2[ i ] = einf2[ out_edge[ i ] ];
+        }
+    }
+}  // generate_part
+
+// Print the SCC.
+void
+ad_scc_view::
+print() const
+{
+    printf( "n = %d m = %d\n", num_nodes(), num_edges() );
+
+    printf( "Edges:\n" );
+    for ( int e = 0; e < num_edges(); ++e ) {
+        printf( "EDGE %d : %d -> %d : w = %d %d\n", e, source( e ), target( e ), 
+                edge_info( e ), edge_info2( e ) );
+    }
+
+    printf( "Out Adj:\n" );
+    for ( int v = 0; v < num_nodes(); ++v ) {
+        printf( "NODE %d WITH %d OUT-EDGES( s ) : ", v, outdegree( v ) );
+        for ( int i = 0; i < outdegree( v ); ++i )
+            printf( " e%d:%d", ith_target_edge( v, i ), ith_target_node( v, i ) );
+        printf( "\n" );
+    }
+
+    printf( "In Adj:\n" );
+    for ( int v = 0; v < num_nodes(); ++v ) {
+        printf( "NODE %d WITH %d IN-EDGES( s ) : ", v, indegree( v ) );
+        for ( int i = 0; i < indegree( v ); ++i )
+            printf( " e%d:%d", ith_source_edge( v, i ), ith_source_node( v, i ) );
+        printf( "\n" );
+    }
+}  // print
+
+///////////////////////////////////////////////////////////////////////
+
 void
 print_components( ad_graph< cninfo >& cg )
 {
@@ -722,70 +1470,86 @@ clear_components( ad_graph< cninfo >& cg )
         delete cg.node_info( v ).comp;
 }
 
-// Find the component properties (number of nodes, number of edges)
-// before dynamic allocation of lists (or arrays) to hold nodes,
-// edges, etc.
+// Find the component properties (number of nodes, number of edges),
+// create the component graph cg, and create a view for each SCC after
+// renumbering g by components.
 void
 find_component_props( ad_graph< cninfo >& cg, 
-                      const ad_graph< ninfo >& g, int *comp_num )
+                      ad_graph< ninfo >& g, int *comp_num )
 {
-    // Allocate only the node list for the component graph.
-    cg.alloc_lists( true, false );
+    int ncomps = cg.num_nodes();
+
+    // Compute the number of edges of the component graph.
+    for ( int e = 0; e < g.num_edges(); ++e ) {
+        // Possible more edges than necessary.
+        if ( comp_num[ g.source( e ) ] != comp_num[ g.target( e ) ] )
+            cg.inc_num_edges();
+    }
+
+    // Allocate lists for the component graph.
+    cg.alloc_lists();
+
+    // Create edges in the component graph. If the end nodes of an edge
+    // have different comp_nums, add an edge into the component graph
+    // between the corresponding SCCs if these SCCs are not adjacent
+    // already. NOTE: I have removed the adjacency code, i.e., we insert
+    // an edge between two SCCs even if they are already adjacent. In
+    // fact, we do not check this at all.
+    for ( int e = 0; e < g.num_edges(); ++e ) {
+        int s = comp_num[ g.source( e ) ];
+        int t = comp_num[ g.target( e ) ];
+
+        if ( s != t ) {
+            // or else if ( !cg.adjacent_slow( s, t ) )
+            cg.ins_edge( s, t, 0, 0 );
+        }
+    }
+
+    // Renumber g such that each SCC is a range of nodes and a range of
+    // edges.
+    int *node_first = new int[ ncomps + 1 ];
+    int *edge_first = new int[ ncomps + 1 ];
+
+    g.sort_by_components( comp_num, ncomps, node_first, edge_first );
 
 #ifdef DEBUG
     try {
 #endif
-        // Create nodes in the component graph.
-        for ( int v = 0; v < cg.num_nodes(); ++v )
-            cg.ins_node( cninfo( new ad_graph< ninfo > ) );
+        // Create nodes in the component graph, each with a view of its
+        // SCC.
+        for ( int k = 0; k < ncomps; ++k ) {
+            cg.ins_node( cninfo( new ad_scc_view( g, 
+                                                  node_first[ k ], 
+                                                  node_first[ k + 1 ] - node_first[ k ],
+                                                  edge_first[ k ],
+                                                  edge_first[ k + 1 ] - edge_first[ k ],
+                                                  false ) ) );
+        }
 #ifdef DEBUG
     } catch ( std::bad_alloc &except ) {
         printf( "ERROR: Memory exhausted.\n" );
         abort();
     }
 #endif
-  
-    // Compute the number of nodes of each SCC.
-    for ( int v = 0; v < g.num_nodes(); ++v )
-        cg.node_info( comp_num[ v ] ).comp->inc_num_nodes();
-
-    // Compute the number of edges of the component graph and each SCC.
-    for ( int e = 0; e < g.num_edges(); ++e ) {
-        int s = g.source( e );
-        int t = g.target( e );
-
-        if ( comp_num[ s ] == comp_num[ t ] )
-            cg.node_info( comp_num[ s ] ).comp->inc_num_edges();
-        else  // Possible more edges than necessary.
-            cg.inc_num_edges();
-    }
-
-#ifdef ADD_SOURCE_NODE
-    // Add 1 for each additional source node.
-    for ( int v = 0; v < cg.num_nodes(); ++v )
-        cg.node_info( v ).comp->inc_num_nodes();
-#endif
-
-    // Allocate lists for each SCC.
-    for ( int v = 0; v < cg.num_nodes(); ++v )
-        cg.node_info( v ).comp->alloc_lists();
 
-    // Allocate lists ( excluding the node list ) for the component graph.
-    cg.alloc_lists( false );
+    delete [] edge_first;
+    delete [] node_first;
 }  // find_component_props
 
-// Create the component graph cg, create each component, and attach
-// them to the nodes of the component graph.
+// Create the component graph cg, find each component, and attach a
+// view of them to the nodes of the component graph. g is renumbered
+// such that no SCC needs to be copied.
 bool
 find_components( ad_graph< cninfo >& cg, 
-                 const ad_graph< ninfo >& g, 
-                 bool has_self_loop, bool already_sc )
+                 ad_graph< ninfo >& g, 
+                 bool has_self_loop, bool already_sc, 
+                 int scc_alg, int nthreads )
 {
     // Construct the component graph cg from g. 
 
     if ( already_sc ) {
         // This is a shortcut. If g is already known to be strongly
-        // connected, this shortcut copies g directly to the single node
+        // connected, this shortcut views g directly from the single node
         // of cg. There is no error checking here. That is, g must be as
         // it is known.
 
@@ -803,46 +1567,9 @@ find_components( ad_graph< cninfo >& cg,
         cg.alloc_lists( true, true );
 
         // Create the only node in cg.
-        cg.ins_node( cninfo( new ad_graph< ninfo > ) );
-
-        // Set parameters of the only SCC.
-        cg.node_info( 0 ).comp->set_num_nodes( g.num_nodes() );
-        cg.node_info( 0 ).comp->set_num_edges( g.num_edges() );
-
-#ifdef ADD_SOURCE_NODE
-        // The source node will all be numbered 0. The source node is
-        // needed for Karp-Orlin and Young-Tarjan-Orlin algorithms.
-        cg.node_info( 0 ).comp->inc_num_nodes();
-#endif
-
-        // Create lists.
-        cg.node_info( 0 ).comp->alloc_lists();
-
-#ifdef CYCLE_MEAN_VERSION
-        for ( int e = 0; e < g.num_edges(); ++e ) {
-            int s = g.source( e );
-            int t = g.target( e );
-#ifdef ADD_SOURCE_NODE
-            cg.node_info( 0 ).comp->ins_edge( s + 1, t + 1, g.edge_info( e ) );
-#else
-            cg.node_info( 0 ).comp->ins_edge( s, t, g.edge_info( e ) );
-#endif
-        }
-
-#else
-        for ( int e = 0; e < g.num_edges(); ++e ) {
-            int s = g.source( e );
-            int t = g.target( e );
-#ifdef ADD_SOURCE_NODE
-            cg.node_info( 0 ).comp->ins_edge( s + 1, t + 1, g.edge_info( e ), g.edge_info2( e ) );
-#else
-            cg.node_info( 0 ).comp->ins_edge( s, t, g.edge_info( e ), g.edge_info2( e ) );
-#endif
-        }
-#endif
+        cg.ins_node( cninfo( new ad_scc_view( g, 0, g.num_nodes(), 
+                                              0, g.num_edges(), false ) ) );
 
-    
-        cg.node_info( 0 ).comp->build_adj();
         cg.build_adj();
     
     } else {
@@ -851,7 +1578,7 @@ find_components( ad_graph< cninfo >& cg,
         int *comp_num = new int[ g.num_nodes() ];
 
         // Set comp_num[v] for each node v.
-        int nsccs = num_sccs( g, comp_num );
+        int nsccs = num_sccs( g, comp_num, scc_alg, nthreads );
 
         // Set the number of nodes of the component graph.
         cg.set_num_nodes( nsccs );
@@ -860,75 +1587,16 @@ find_components( ad_graph< cninfo >& cg,
 #endif
 
         // Check to see if g is acyclic. If so, exit.
-        if ( ( cg.num_nodes() == g.num_nodes() ) && ( !has_self_loop ) )
+        if ( ( cg.num_nodes() == g.num_nodes() ) && ( !has_self_loop ) ) {
+            delete [] comp_num;
             return true;  
-
-        // Determine the properties of SCCs.
-        find_component_props( cg, g, comp_num );
-
-        // Create a map from the SCC nodes to the nodes in the original
-        // input graph, i.e., graph g.
-        int *scc2orig = new int[ g.num_nodes() ];
-
-#ifdef ADD_SOURCE_NODE
-        // Create the source node in each SCC. The source node will all be
-        // numbered 0. The source node is needed for Karp-Orlin and
-        // Young-Tarjan-Orlin algorithms.
-        for ( int v = 0; v < cg.num_nodes(); ++v )
-            cg.node_info( v ).comp->ins_node();
-#endif
-
-        // Create (the remaining) nodes in each SCC:
-        for ( int v = 0; v < g.num_nodes(); ++v )
-            scc2orig[ v ] = cg.node_info( comp_num[ v ] ).comp->ins_node();
-
-        // Create edges in the component graph and the SCCs. If the end
-        // nodes of an edge have the same comp_num, insert them into the
-        // same SCC; otherwise, add an edge into the component graph between
-        // the corresponding SCCs if these SCCs are not adjacent already.
-        // NOTE: I have removed the adjacency code, i.e., we insert an edge
-        // between two SCCs even if they are already adjacent. In fact, we
-        // do not check this at all.
-#ifdef CYCLE_MEAN_VERSION
-        for ( int e = 0; e < g.num_edges(); ++e ) {
-            int s = g.source( e );
-            int t = g.target( e );
-
-            if ( comp_num[ s ] == comp_num[ t ] ) {
-                cg.node_info( comp_num[ s ] ).comp->ins_edge( scc2orig[ s ], 
-                                                              scc2orig[ t ], 
-                                                              g.edge_info( e ) );
-            } else {
-                // or else if ( !cg.adjacent_slow( comp_num[ s ], comp_num[ t ] ) )
-                cg.ins_edge( comp_num[ s ], comp_num[ t ], 0 );
-            }
-        }
-
-#else
-        for ( int e = 0; e < g.num_edges(); ++e ) {
-            int s = g.source( e );
-            int t = g.target( e );
-
-            if ( comp_num[ s ] == comp_num[ t ] ) {
-                cg.node_info( comp_num[ s ] ).comp->ins_edge( scc2orig[ s ], 
-                                                              scc2orig[ t ], 
-                                                              g.edge_info( e ),
-                                                              g.edge_info2( e ) );
-            } else {
-                // or else if ( !cg.adjacent_slow( comp_num[ s ], comp_num[ t ] ) )
-                cg.ins_edge( comp_num[ s ], comp_num[ t ], 0, 0 );
-            }
         }
-#endif
 
+        // Determine the properties of SCCs and create them.
+        find_component_props( cg, g, comp_num );
 
-        delete [] scc2orig;
         delete [] comp_num;
 
-        // Build the adjacency lists for each SCC.
-        for ( int v = 0; v < cg.num_nodes(); ++v )
-            cg.node_info( v ).comp->build_adj();
-
         // Build the adjacency lists of the component graph cg.
         cg.build_adj();
     }
@@ -937,16 +1605,34 @@ find_components( ad_graph< cninfo >& cg,
 }  // find_components
 
 // Find which SCC each node blongs and return the info in
-// comp_num. Also return the number of SCCs. The algorithm used is the
-// one in the book by CLR. This algorithm uses depth-first search.
+// comp_num. Also return the number of SCCs. The two-pass and the
+// one-pass algorithms number the SCCs in topological order; the
+// parallel one, in the order of their smallest node.
+int
+num_sccs( const ad_graph< ninfo >& g, int *comp_num, int scc_alg, int nthreads )
+{
+    if ( SCC_ONE_PASS == scc_alg )
+        return num_sccs_one_pass( g, comp_num );
+    if ( SCC_PARALLEL == scc_alg )
+        return num_sccs_parallel( g, comp_num, nthreads );
+    return num_sccs_two_pass( g, comp_num );
+}  // num_sccs
+
+// The algorithm used is the one in the book by CLR. This algorithm
+// uses depth-first search.
 int
-num_sccs( const ad_graph< ninfo >& g, int *comp_num )
+num_sccs_two_pass( const ad_graph< ninfo >& g, int *comp_num )
 {
     int n = g.num_nodes();
 
     int  *node_list = new int[ n ];
     bool *not_visited = new bool[ n ];
 
+    // The DFS stack shared by all the roots of both passes. Allocating
+    // it per root costs O(n) per root, i.e., O(n^2) on graphs with
+    // many small SCCs.
+    dfs_stack_entry *stack = new dfs_stack_entry[ n ];
+
     for ( int v = 0; v < n; ++v ) {
         not_visited[ v ] = true;
         comp_num[ v ] = -1;
@@ -955,7 +1641,7 @@ num_sccs( const ad_graph< ninfo >& g, int *comp_num )
     int nvisited = n;
     for ( int v = 0; v < n; ++v ) {
         if ( not_visited[ v ] )
-            traverse_via_outedges( g, v, not_visited, nvisited, node_list );
+            traverse_via_outedges( g, v, not_visited, nvisited, node_list, stack );
     }
 
     delete [] not_visited;
@@ -964,15 +1650,118 @@ num_sccs( const ad_graph< ninfo >& g, int *comp_num )
     for ( int v = 0; v < n; ++v ) {
         int u = node_list[ v ];
         if ( -1 == comp_num[ u ] ) {
-            traverse_via_inedges( g, u, num_comps, comp_num );
+            traverse_via_inedges( g, u, num_comps, comp_num, stack );
             ++num_comps;
         }
     }
 
+    delete [] stack;
     delete [] node_list;
   
     return num_comps;
-}
+}  // num_sccs_two_pass
+
+// The algorithm used is Pearce's variant of Tarjan's algorithm
+// ("A space-efficient algorithm for finding strongly connected
+// components", IPL 2016), made iterative. It makes one DFS pass over
+// the outedges only, and comp_num doubles as its only per-node array:
+// while a node is on the DFS path or on the SCC stack, comp_num holds
+// the smallest DFS index it reaches; once its SCC is found, it holds
+// the SCC number counting down from n-1. The DFS indices of the active
+// nodes are always below the SCC numbers, so one comparison serves
+// both. The SCCs are found in reverse topological order, so their
+// numbers are shifted at the end to start from 0 in topological order.
+int
+num_sccs_one_pass( const ad_graph< ninfo >& g, int *comp_num )
+{
+    // DFS path entry: a node, the index of its next outedge, and
+    // whether it is still the root of its SCC.
+    struct dfs_entry {
+        int  node;
+        int  edge_index;
+        bool root;
+    };
+
+    int n = g.num_nodes();
+
+    dfs_entry *path = new dfs_entry[ n ];
+    int       *stack = new int[ n ];
+    int       path_top = 0;
+    int       stack_top = 0;
+
+    int index = 0;      // Next DFS index.
+    int c = n - 1;      // Next SCC number.
+
+    for ( int v = 0; v < n; ++v )
+        comp_num[ v ] = -1;
+
+    for ( int r = 0; r < n; ++r ) {
+        if ( -1 != comp_num[ r ] )
+            continue;
+
+        comp_num[ r ] = index++;
+        path[ 0 ].node = r;
+        path[ 0 ].edge_index = 0;
+        path[ 0 ].root = true;
+        path_top = 1;
+
+        while ( path_top > 0 ) {
+            dfs_entry& current = path[ path_top - 1 ];
+            int v = current.node;
+
+            if ( current.edge_index < g.outdegree( v ) ) {
+                int t = g.ith_target_node( v, current.edge_index );
+                current.edge_index++;
+
+                if ( -1 == comp_num[ t ] ) {
+                    comp_num[ t ] = index++;
+                    path[ path_top ].node = t;
+                    path[ path_top ].edge_index = 0;
+                    path[ path_top ].root = true;
+                    path_top++;
+                } else if ( comp_num[ t ] < comp_num[ v ] ) {
+                    comp_num[ v ] = comp_num[ t ];
+                    current.root = false;
+                }
+                continue;
+            }
+
+            // All outedges of v are done.
+            path_top--;
+            if ( current.root ) {
+                // v is the root of a SCC made of v and the nodes above
+                // it on the SCC stack.
+                --index;
+                while ( ( stack_top > 0 ) && 
+                        ( comp_num[ v ] <= comp_num[ stack[ stack_top - 1 ] ] ) ) {
+                    comp_num[ stack[ --stack_top ] ] = c;
+                    --index;
+                }
+                comp_num[ v ] = c;
+                --c;
+            } else {
+                stack[ stack_top++ ] = v;
+            }
+
+            if ( path_top > 0 ) {
+                dfs_entry& parent = path[ path_top - 1 ];
+                if ( comp_num[ v ] < comp_num[ parent.node ] ) {
+                    comp_num[ parent.node ] = comp_num[ v ];
+                    parent.root = false;
+                }
+            }
+        }  // while
+    }  // for each r
+
+    delete [] stack;
+    delete [] path;
+
+    // The SCCs are numbered c+1, ..., n-1 in reverse topological order.
+    for ( int v = 0; v < n; ++v )
+        comp_num[ v ] -= c + 1;
+
+    return n - 1 - c;
+}  // num_sccs_one_pass
 
 // Traverse the graph g using the outgoing edges. This algorithm is a
 // top-level algorithm calling an iterative or recursive depth-first
@@ -980,12 +1769,13 @@ num_sccs( const ad_graph< ninfo >& g, int *comp_num )
 void
 traverse_via_outedges( const ad_graph< ninfo >& g,
                        int start_v, bool *not_visited,
-                       int& n, int *node_list )
+                       int& n, int *node_list,
+                       dfs_stack_entry *stack )
 {
 #ifdef DFS_RECUR
     traverse_via_outedges_recur(g, start_v, not_visited, n, node_list);
 #else
-    traverse_via_outedges_iter(g, start_v, not_visited, n, node_list);
+    traverse_via_outedges_iter(g, start_v, not_visited, n, node_list, stack);
 #endif
 }
 
@@ -994,17 +1784,9 @@ traverse_via_outedges( const ad_graph< ninfo >& g,
 void
 traverse_via_outedges_iter( const ad_graph< ninfo >& g,
                             int start_v, bool *not_visited,
-                            int& n, int *node_list )
+                            int& n, int *node_list,
+                            dfs_stack_entry *stack )
 {
-    // Structure to store node and edge index on stack
-    struct stack_entry {
-        int node;
-        int edge_index;
-    };
-    
-    // Allocate stack - maximum size needed is number of nodes
-    int stack_size = g.num_nodes();
-    stack_entry* stack = new stack_entry[ stack_size ];
     int stack_top = 0;  // Index of top of stack
     
     // Push initial node
@@ -1015,7 +1797,7 @@ traverse_via_outedges_iter( const ad_graph< ninfo >& g,
     
     while ( stack_top > 0 ) {
         // Get reference to top stack entry
-        stack_entry& current = stack[ stack_top - 1 ];
+        dfs_stack_entry& current = stack[ stack_top - 1 ];
         
         // If we've processed all out-edges of current node
         if ( current.edge_index >= g.outdegree( current.node ) ) {
@@ -1036,9 +1818,6 @@ traverse_via_outedges_iter( const ad_graph< ninfo >& g,
             stack_top++;
         }
     }
-    
-    // Free allocated memory
-    delete[] stack;
 } // traverse_via_outedges_iter
 
 // Traverse the graph g using the outgoing edges. This algorithm is a
@@ -1068,12 +1847,13 @@ traverse_via_outedges_recur( const ad_graph< ninfo >& g,
 // search algorithm.
 void
 traverse_via_inedges( const ad_graph< ninfo >& g,
-                      int start_v, int num_comps, int *comp_num)
+                      int start_v, int num_comps, int *comp_num,
+                      dfs_stack_entry *stack )
 {
 #ifdef DFS_RECUR
     traverse_via_inedges_recur(g, start_v, num_comps, comp_num);
 #else
-    traverse_via_inedges_iter(g, start_v, num_comps, comp_num);
+    traverse_via_inedges_iter(g, start_v, num_comps, comp_num, stack);
 #endif
    
 } // traverse_via_inedges
@@ -1082,17 +1862,9 @@ traverse_via_inedges( const ad_graph< ninfo >& g,
 // iterative depth-first search algorithm.
 void
 traverse_via_inedges_iter( const ad_graph< ninfo >& g,
-                           int start_v, int num_comps, int *comp_num)
+                           int start_v, int num_comps, int *comp_num,
+                           dfs_stack_entry *stack )
 {
-    // Structure to store node and edge index on stack
-    struct stack_entry {
-        int node;
-        int edge_index;
-    };
-    
-    // Allocate stack - maximum size needed is number of nodes
-    int stack_size = g.num_nodes();
-    stack_entry* stack = new stack_entry[ stack_size ];
     int stack_top = 0;  // Index of top of stack
     
     // Push initial node
@@ -1103,7 +1875,7 @@ traverse_via_inedges_iter( const ad_graph< ninfo >& g,
     
     while ( stack_top > 0 ) {
         // Get reference to top stack entry
-        stack_entry& current = stack[ stack_top - 1 ];
+        dfs_stack_entry& current = stack[ stack_top - 1 ];
         
         // If we've processed all in-edges of current node
         if ( current.edge_index >= g.indegree( current.node ) ) {
@@ -1123,9 +1895,6 @@ traverse_via_inedges_iter( const ad_graph< ninfo >& g,
             stack_top++;
         }
     }
-    
-    // Free allocated memory
-    delete[] stack;
 } // traverse_via_inedges_iter
 
 // Traverse the graph g using the incoming edges. This algorithm is a
@@ -1147,31 +1916,1169 @@ traverse_via_inedges_recur( const ad_graph< ninfo >& g,
     }
 }  // traverse_via_inedges_recur
 
-void
-generate_part_for_all_components( ad_graph< cninfo >& cg,
-                                  ginfo& gi,
-                                  const args_t& args )
-{
-    for ( int v = 0; v < cg.num_nodes(); ++v ) {
-        ad_graph< ninfo > *scc = cg.node_info( v ).comp;
-        if ( scc->num_edges() ) {
-            scc->generate_part( gi, args );
-        }
-    }
-}  // generate_for_all_components
-
 ///////////////////////////////////////////////////////////////////////
-
-float
-find_min_cycle_ratio_for_components( const ad_graph< cninfo >& cg,
-                                     int plus_infinity )
+// Parallel SCC decomposition:
+//
+// Phase 1 uses all the threads on the whole graph. It removes the
+// trivial SCCs by trimming the nodes with no inedges or no outedges,
+// finds the SCC of a pivot node, which is usually the giant SCC, by a
+// forward (FW) and a backward (BW) reach from the pivot, and trims
+// again. The nodes left are split by color into the nodes reached
+// only by FW, only by BW, and by neither. No SCC spans two colors.
+//
+// Phase 2 solves the colors as independent tasks, one task per thread
+// at a time. A large task is split again by a serial FW-BW from a
+// pivot; a small one is solved by a serial one-pass algorithm.
+//
+// While the algorithm runs, comp_num[v] is -1 or a node of the SCC of
+// v. The SCCs are numbered at the end in the order of their smallest
+// node, so the numbers do not depend on the thread timing.
+
+// Node marks.
+const char PSCC_FW = 1;  // Reached from the pivot via outedges.
+const char PSCC_BW = 2;  // Reached from the pivot via inedges.
+
+const int PSCC_BLOCK = 4096;       // Nodes per block in parallel loops.
+const int PSCC_CHUNK = 256;        // Nodes moved at once to idle threads.
+const int PSCC_MIN_SPLIT = 4096;   // Smallest task split by FW-BW.
+
+// A stack of ints that grows as needed.
+struct int_stack {
+    int_stack()
+    {
+        cap = 1024;
+        buf = new int[ cap ];
+        top = 0;
+    }
+    ~int_stack()
+    {
+        delete [] buf;
+    }
+
+    bool is_empty() const
+    {
+        return ( 0 == top );
+    }
+    void push( int v )
+    {
+        if ( top == cap ) {
+            int *new_buf = new int[ 2 * cap ];
+            memcpy( new_buf, buf, cap * sizeof( int ) );
+            delete [] buf;
+            buf = new_buf;
+            cap *= 2;
+        }
+        buf[ top++ ] = v;
+    }
+    int pop()
+    {
+        return buf[ --top ];
+    }
+
+    int *buf;
+    int top;
+    int cap;
+};
+
+// A phase 2 task: the nodes nodes[first], ..., nodes[last-1], which
+// are all the nodes of color color.
+struct pscc_task {
+    int  first;
+    int  last;
+    int  color;
+    bool can_split;  // False if the last split made little progress.
+};
+
+// Work shared by the threads.
+struct pscc_work {
+    const ad_graph< ninfo > *g;
+    int  n;
+    int  *comp_num;
+    int  *color;     // Subproblem of each node.
+    int  *in_cnt;    // Number of inedges from the same color; for trimming.
+    int  *out_cnt;   // Number of outedges to the same color; for trimming.
+    char *mark;      // PSCC_FW and PSCC_BW marks.
+    int  *rindex;    // Scratch for the one-pass algorithm.
+    int  *nodes;     // Nodes of the phase 2 tasks.
+    int  next;       // Next node block in parallel loops.
+    int  next_color;
+    int  pivot;
+    int  split_size; // Tasks at least this large are split by FW-BW.
+
+    // Shared stack of nodes to reach from, or of tasks to solve. A
+    // thread waits on cond when there is nothing for it; all the work
+    // is done when all the threads wait.
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int             nthreads;
+    int             nidle;
+    bool            done;
+    char            reach_mark;    // PSCC_FW or PSCC_BW.
+    int             *shared;
+    int             nshared;
+    pscc_task       *tasks;
+    int             ntasks;
+};
+
+inline
+int
+load_relaxed( const int *p )
 {
-    float lambda = ( float ) plus_infinity;
-    for ( int v = 0; v < cg.num_nodes(); ++v ) {
+    return __atomic_load_n( p, __ATOMIC_RELAXED );
+}
+
+// Claim the unassigned node v for the SCC of node rep. Return true if
+// no other thread claimed v before.
+inline
+bool
+claim_node( pscc_work *w, int v, int rep )
+{
+    int unassigned = -1;
+    return __atomic_compare_exchange_n( &w->comp_num[ v ], &unassigned, rep, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED );
+}
+
+// Return the group of a node by its marks: 0 if reached only by FW, 1
+// if only by BW, 2 if by neither, and 3 if by both, i.e., if it is in
+// the SCC of the pivot.
+inline
+int
+mark_group( char m )
+{
+    switch ( m ) {
+    case PSCC_FW:
+        return 0;
+    case PSCC_BW:
+        return 1;
+    case 0:
+        return 2;
+    }
+    return 3;
+}
+
+// Get the next block of nodes [first, last) in a parallel loop.
+inline
+bool
+next_block( pscc_work *w, int& first, int& last )
+{
+    first = __atomic_fetch_add( &w->next, PSCC_BLOCK, __ATOMIC_RELAXED );
+    last = min( first + PSCC_BLOCK, w->n );
+    return ( first < w->n );
+}
+
+// Wait until *nwork, the size of the shared stack, is not zero or all
+// the threads are idle. Return false in the latter case.
+// pre: w->lock is held.
+bool
+wait_for_work( pscc_work *w, const int *nwork )
+{
+    // nidle is also read without the lock by reach_nodes.
+    __atomic_add_fetch( &w->nidle, 1, __ATOMIC_RELAXED );
+    while ( !w->done && ( 0 == *nwork ) ) {
+        if ( w->nidle == w->nthreads ) {
+            w->done = true;
+            pthread_cond_broadcast( &w->cond );
+            break;
+        }
+        pthread_cond_wait( &w->cond, &w->lock );
+    }
+    if ( w->done )
+        return false;
+    __atomic_sub_fetch( &w->nidle, 1, __ATOMIC_RELAXED );
+    return true;
+}  // wait_for_work
+
+// Count the edges between the unassigned nodes of the same color.
+void *
+count_degrees( void *arg )
+{
+    pscc_work *w = ( pscc_work * ) arg;
+    const ad_graph< ninfo >& g = *w->g;
+    int first, last;
+
+    while ( next_block( w, first, last ) ) {
+        for ( int v = first; v < last; ++v ) {
+            if ( -1 != w->comp_num[ v ] )
+                continue;
+
+            int c = w->color[ v ];
+            int k = 0;
+            for ( int i = 0; i < g.indegree( v ); ++i ) {
+                int s = g.ith_source_node( v, i );
+                if ( ( -1 == w->comp_num[ s ] ) && ( c == w->color[ s ] ) )
+                    ++k;
+            }
+            w->in_cnt[ v ] = k;
+
+            k = 0;
+            for ( int i = 0; i < g.outdegree( v ); ++i ) {
+                int t = g.ith_target_node( v, i );
+                if ( ( -1 == w->comp_num[ t ] ) && ( c == w->color[ t ] ) )
+                    ++k;
+            }
+            w->out_cnt[ v ] = k;
+        }
+    }
+    return NULL;
+}  // count_degrees
+
+// Trim the nodes with no inedges or no outedges in their color, each
+// into its own SCC. Removing a node can leave its neighbors with no
+// inedges or outedges, so those are trimmed too by the thread that
+// removes their last edge.
+// pre: count_degrees is done.
+void *
+trim_nodes( void *arg )
+{
+    pscc_work *w = ( pscc_work * ) arg;
+    const ad_graph< ninfo >& g = *w->g;
+    int_stack stack;
+    int first, last;
+
+    while ( next_block( w, first, last ) ) {
+        for ( int v = first; v < last; ++v ) {
+            if ( ( -1 == load_relaxed( &w->comp_num[ v ] ) ) &&
+                 ( ( 0 == load_relaxed( &w->in_cnt[ v ] ) ) ||
+                   ( 0 == load_relaxed( &w->out_cnt[ v ] ) ) ) &&
+                 claim_node( w, v, v ) )
+                stack.push( v );
+
+            while ( !stack.is_empty() ) {
+                int u = stack.pop();
+                int c = w->color[ u ];
+
+                for ( int i = 0; i < g.outdegree( u ); ++i ) {
+                    int t = g.ith_target_node( u, i );
+                    if ( ( c == w->color[ t ] ) &&
+                         ( -1 == load_relaxed( &w->comp_num[ t ] ) ) &&
+                         ( 0 == __atomic_sub_fetch( &w->in_cnt[ t ], 1, __ATOMIC_RELAXED ) ) &&
+                         claim_node( w, t, t ) )
+                        stack.push( t );
+                }
+                for ( int i = 0; i < g.indegree( u ); ++i ) {
+                    int s = g.ith_source_node( u, i );
+                    if ( ( c == w->color[ s ] ) &&
+                         ( -1 == load_relaxed( &w->comp_num[ s ] ) ) &&
+                         ( 0 == __atomic_sub_fetch( &w->out_cnt[ s ], 1, __ATOMIC_RELAXED ) ) &&
+                         claim_node( w, s, s ) )
+                        stack.push( s );
+                }
+            }
+        }
+    }
+    return NULL;
+}  // trim_nodes
+
+// Mark the unassigned nodes reached from the nodes on the shared stack
+// with w->reach_mark. Each thread expands the nodes on its own stack
+// and moves a chunk of them to the shared stack when another thread is
+// idle.
+void *
+reach_nodes( void *arg )
+{
+    pscc_work *w = ( pscc_work * ) arg;
+    const ad_graph< ninfo >& g = *w->g;
+    char bit = w->reach_mark;
+    bool forward = ( PSCC_FW == bit );
+    int_stack stack;
+
+    while ( true ) {
+        if ( stack.is_empty() ) {
+            pthread_mutex_lock( &w->lock );
+            if ( !wait_for_work( w, &w->nshared ) ) {
+                pthread_mutex_unlock( &w->lock );
+                break;
+            }
+            for ( int k = 0; ( k < PSCC_CHUNK ) && ( 0 < w->nshared ); ++k )
+                stack.push( w->shared[ --w->nshared ] );
+            pthread_mutex_unlock( &w->lock );
+        }
+
+        int v = stack.pop();
+        int deg = ( forward ? g.outdegree( v ) : g.indegree( v ) );
+        for ( int i = 0; i < deg; ++i ) {
+            int t = ( forward ? g.ith_target_node( v, i ) : g.ith_source_node( v, i ) );
+            if ( ( -1 == w->comp_num[ t ] ) &&
+                 !( __atomic_fetch_or( &w->mark[ t ], bit, __ATOMIC_RELAXED ) & bit ) )
+                stack.push( t );
+        }
+
+        if ( ( stack.top > 2 * PSCC_CHUNK ) && ( 0 < __atomic_load_n( &w->nidle, __ATOMIC_RELAXED ) ) ) {
+            pthread_mutex_lock( &w->lock );
+            for ( int k = 0; k < PSCC_CHUNK; ++k )
+                w->shared[ w->nshared++ ] = stack.pop();
+            pthread_cond_broadcast( &w->cond );
+            pthread_mutex_unlock( &w->lock );
+        }
+    }
+    return NULL;
+}  // reach_nodes
+
+// Put the nodes reached by both FW and BW into the SCC of the pivot,
+// and color the other unassigned nodes by which reach found them.
+void *
+split_nodes( void *arg )
+{
+    pscc_work *w = ( pscc_work * ) arg;
+    int first, last;
+
+    while ( next_block( w, first, last ) ) {
+        for ( int v = first; v < last; ++v ) {
+            if ( -1 != w->comp_num[ v ] )
+                continue;
+            int group = mark_group( w->mark[ v ] );
+            if ( 3 == group )
+                w->comp_num[ v ] = w->pivot;
+            else
+                w->color[ v ] = w->next_color + group;
+            w->mark[ v ] = 0;
+        }
+    }
+    return NULL;
+}  // split_nodes
+
+// Run func on all the threads, each taking node blocks from w->next.
+inline
+void
+run_block_loop( pscc_work *w, void *( *func )( void * ) )
+{
+    w->next = 0;
+    run_threads( w->nthreads, func, w );
+}  // run_block_loop
+
+void
+trim_all( pscc_work *w )
+{
+    run_block_loop( w, count_degrees );
+    run_block_loop( w, trim_nodes );
+}  // trim_all
+
+// Mark the nodes that the pivot reaches with the given mark.
+void
+reach_all( pscc_work *w, char bit )
+{
+    w->mark[ w->pivot ] |= bit;
+    w->shared[ 0 ] = w->pivot;
+    w->nshared = 1;
+    w->nidle = 0;
+    w->done = false;
+    w->reach_mark = bit;
+    run_threads( w->nthreads, reach_nodes, w );
+}  // reach_all
+
+// Add a task unless it has no nodes.
+// pre: w->lock is held.
+void
+add_task( pscc_work *w, int first, int last, int color, bool can_split )
+{
+    if ( first == last )
+        return;
+    pscc_task& t = w->tasks[ w->ntasks++ ];
+    t.first = first;
+    t.last = last;
+    t.color = color;
+    t.can_split = can_split;
+}  // add_task
+
+// Find the SCC of a pivot of the task by a serial FW-BW, and add the
+// rest of the task as up to three new tasks.
+void
+split_task( pscc_work *w, const pscc_task& task )
+{
+    const ad_graph< ninfo >& g = *w->g;
+    int *nodes = w->nodes;
+    int c = task.color;
+    int pivot = nodes[ ( task.first + task.last ) / 2 ];
+    int_stack stack;
+
+    for ( int k = 0; k < 2; ++k ) {
+        bool forward = ( 0 == k );
+        char bit = ( forward ? PSCC_FW : PSCC_BW );
+
+        w->mark[ pivot ] |= bit;
+        stack.push( pivot );
+        while ( !stack.is_empty() ) {
+            int v = stack.pop();
+            int deg = ( forward ? g.outdegree( v ) : g.indegree( v ) );
+            for ( int i = 0; i < deg; ++i ) {
+                int t = ( forward ? g.ith_target_node( v, i ) : g.ith_source_node( v, i ) );
+                if ( ( c == load_relaxed( &w->color[ t ] ) ) && !( w->mark[ t ] & bit ) ) {
+                    w->mark[ t ] |= bit;
+                    stack.push( t );
+                }
+            }
+        }
+    }
+
+    // Move the nodes of each new color together: FW only, BW only,
+    // then neither.
+    int size = task.last - task.first;
+    int new_color = __atomic_fetch_add( &w->next_color, 3, __ATOMIC_RELAXED );
+    int count[ 4 ] = { 0, 0, 0, 0 };
+    int *tmp = new int[ size ];
+
+    for ( int k = 0; k < size; ++k ) {
+        count[ mark_group( w->mark[ nodes[ task.first + k ] ] ) ]++;
+    }
+    int next[ 3 ] = { task.first, task.first + count[ 0 ], task.first + count[ 0 ] + count[ 1 ] };
+    for ( int k = 0; k < size; ++k )
+        tmp[ k ] = nodes[ task.first + k ];
+    for ( int k = 0; k < size; ++k ) {
+        int v = tmp[ k ];
+        int group = mark_group( w->mark[ v ] );
+        w->mark[ v ] = 0;
+        if ( 3 == group ) {
+            w->comp_num[ v ] = pivot;
+            __atomic_store_n( &w->color[ v ], -1, __ATOMIC_RELAXED );
+            continue;
+        }
+        __atomic_store_n( &w->color[ v ], new_color + group, __ATOMIC_RELAXED );
+        nodes[ next[ group ]++ ] = v;
+    }
+    delete [] tmp;
+
+    // Stop splitting a task that does not shrink much.
+    pthread_mutex_lock( &w->lock );
+    int first = task.first;
+    for ( int group = 0; group < 3; ++group ) {
+        bool can_split = ( 8 * count[ group ] < 7 * size );
+        add_task( w, first, first + count[ group ], new_color + group, can_split );
+        first += count[ group ];
+    }
+    pthread_cond_broadcast( &w->cond );
+    pthread_mutex_unlock( &w->lock );
+}  // split_task
+
+// Find the SCCs of the task by the one-pass algorithm of
+// num_sccs_one_pass, with rindex in place of comp_num, following only
+// the edges inside the task's color.
+void
+solve_task( pscc_work *w, const pscc_task& task )
+{
+    struct dfs_entry {
+        int  node;
+        int  edge_index;
+        bool root;
+    };
+
+    const ad_graph< ninfo >& g = *w->g;
+    int *rindex = w->rindex;
+    int c = task.color;
+    int size = task.last - task.first;
+
+    dfs_entry *path = new dfs_entry[ size ];
+    int       *stack = new int[ size ];
+    int       path_top = 0;
+    int       stack_top = 0;
+    int       index = 0;
+    int       cnum = size - 1;
+
+    for ( int k = task.first; k < task.last; ++k )
+        rindex[ w->nodes[ k ] ] = -1;
+
+    for ( int k = task.first; k < task.last; ++k ) {
+        int r = w->nodes[ k ];
+        if ( -1 != rindex[ r ] )
+            continue;
+
+        rindex[ r ] = index++;
+        path[ 0 ].node = r;
+        path[ 0 ].edge_index = 0;
+        path[ 0 ].root = true;
+        path_top = 1;
+
+        while ( path_top > 0 ) {
+            dfs_entry& current = path[ path_top - 1 ];
+            int v = current.node;
+
+            if ( current.edge_index < g.outdegree( v ) ) {
+                int t = g.ith_target_node( v, current.edge_index );
+                current.edge_index++;
+
+                if ( c != load_relaxed( &w->color[ t ] ) )
+                    continue;
+
+                if ( -1 == rindex[ t ] ) {
+                    rindex[ t ] = index++;
+                    path[ path_top ].node = t;
+                    path[ path_top ].edge_index = 0;
+                    path[ path_top ].root = true;
+                    path_top++;
+                } else if ( rindex[ t ] < rindex[ v ] ) {
+                    rindex[ v ] = rindex[ t ];
+                    current.root = false;
+                }
+                continue;
+            }
+
+            path_top--;
+            if ( current.root ) {
+                --index;
+                while ( ( stack_top > 0 ) &&
+                        ( rindex[ v ] <= rindex[ stack[ stack_top - 1 ] ] ) ) {
+                    int u = stack[ --stack_top ];
+                    rindex[ u ] = cnum;
+                    w->comp_num[ u ] = v;
+                    --index;
+                }
+                rindex[ v ] = cnum;
+                w->comp_num[ v ] = v;
+                --cnum;
+            } else {
+                stack[ stack_top++ ] = v;
+            }
+
+            if ( path_top > 0 ) {
+                dfs_entry& parent = path[ path_top - 1 ];
+                if ( rindex[ v ] < rindex[ parent.node ] ) {
+                    rindex[ parent.node ] = rindex[ v ];
+                    parent.root = false;
+                }
+            }
+        }  // while
+    }  // for each k
+
+    delete [] stack;
+    delete [] path;
+}  // solve_task
+
+void *
+solve_tasks( void *arg )
+{
+    pscc_work *w = ( pscc_work * ) arg;
+
+    while ( true ) {
+        pthread_mutex_lock( &w->lock );
+        if ( !wait_for_work( w, &w->ntasks ) ) {
+            pthread_mutex_unlock( &w->lock );
+            break;
+        }
+        pscc_task task = w->tasks[ --w->ntasks ];
+        pthread_mutex_unlock( &w->lock );
+
+        if ( task.can_split && ( task.last - task.first >= w->split_size ) )
+            split_task( w, task );
+        else
+            solve_task( w, task );
+    }
+    return NULL;
+}  // solve_tasks
+
+// The algorithm is explained above.
+int
+num_sccs_parallel( const ad_graph< ninfo >& g, int *comp_num, int nthreads )
+{
+    int n = g.num_nodes();
+
+    pscc_work w;
+    w.g = &g;
+    w.n = n;
+    w.comp_num = comp_num;
+    w.color = new int[ n ];
+    w.in_cnt = new int[ n ];
+    w.out_cnt = new int[ n ];
+    w.mark = new char[ n ];
+    w.rindex = new int[ n ];
+    w.nodes = new int[ n ];
+    w.shared = new int[ n ];
+    w.tasks = NULL;
+    w.nthreads = nthreads;
+    pthread_mutex_init( &w.lock, NULL );
+    pthread_cond_init( &w.cond, NULL );
+
+    for ( int v = 0; v < n; ++v ) {
+        comp_num[ v ] = -1;
+        w.color[ v ] = 0;
+        w.mark[ v ] = 0;
+    }
+
+    // Phase 1.
+    trim_all( &w );
+
+    // Pick the pivot with the most paths through it, which most likely
+    // is in the giant SCC if there is one.
+    w.pivot = -1;
+    long best = -1;
+    for ( int v = 0; v < n; ++v ) {
+        if ( ( -1 == comp_num[ v ] ) && ( ( long ) w.in_cnt[ v ] * w.out_cnt[ v ] > best ) ) {
+            best = ( long ) w.in_cnt[ v ] * w.out_cnt[ v ];
+            w.pivot = v;
+        }
+    }
+
+    int nleft = 0;
+    if ( -1 != w.pivot ) {
+        reach_all( &w, PSCC_FW );
+        reach_all( &w, PSCC_BW );
+        w.next_color = 1;
+        run_block_loop( &w, split_nodes );
+        w.next_color = 4;
+        trim_all( &w );
+
+        // Sort the nodes left by color.
+        int count[ 4 ] = { 0, 0, 0, 0 };
+        for ( int v = 0; v < n; ++v ) {
+            if ( -1 == comp_num[ v ] )
+                count[ w.color[ v ] ]++;
+        }
+        int next[ 4 ] = { 0, 0, count[ 1 ], count[ 1 ] + count[ 2 ] };
+        for ( int v = 0; v < n; ++v ) {
+            if ( -1 == comp_num[ v ] )
+                w.nodes[ next[ w.color[ v ] ]++ ] = v;
+            else
+                w.color[ v ] = -1;
+        }
+        nleft = count[ 1 ] + count[ 2 ] + count[ 3 ];
+
+        // Phase 2. Each split adds at most three tasks and assigns at
+        // least one node, so there are never more than n tasks.
+        w.tasks = new pscc_task[ n ];
+        w.ntasks = 0;
+        w.nidle = 0;
+        w.done = false;
+        w.split_size = max( PSCC_MIN_SPLIT, nleft / ( 4 * nthreads ) );
+        add_task( &w, 0, count[ 1 ], 1, true );
+        add_task( &w, count[ 1 ], count[ 1 ] + count[ 2 ], 2, true );
+        add_task( &w, count[ 1 ] + count[ 2 ], nleft, 3, true );
+        run_threads( nthreads, solve_tasks, &w );
+        delete [] w.tasks;
+    }
+
+    // Number the SCCs in the order of their smallest node.
+    int *new_num = w.rindex;
+    for ( int v = 0; v < n; ++v )
+        new_num[ v ] = -1;
+    int ncomps = 0;
+    for ( int v = 0; v < n; ++v ) {
+        int r = comp_num[ v ];
+        if ( -1 == new_num[ r ] )
+            new_num[ r ] = ncomps++;
+        comp_num[ v ] = new_num[ r ];
+    }
 
-        const ad_graph< ninfo > *scc = cg.node_info( v ).comp;
+    pthread_cond_destroy( &w.cond );
+    pthread_mutex_destroy( &w.lock );
+    delete [] w.shared;
+    delete [] w.nodes;
+    delete [] w.rindex;
+    delete [] w.mark;
+    delete [] w.out_cnt;
+    delete [] w.in_cnt;
+    delete [] w.color;
 
+    return ncomps;
+}  // num_sccs_parallel
+
+void
+generate_part_for_all_components( ad_graph< cninfo >& cg,
+                                  ginfo& gi,
+                                  const args_t& args )
+{
+    for ( int v = 0; v < cg.num_nodes(); ++v ) {
+        ad_scc_view *scc = cg.node_info( v ).comp;
         if ( scc->num_edges() ) {
+            scc->generate_part( gi, args );
+        }
+    }
+}  // generate_for_all_components
+
+///////////////////////////////////////////////////////////////////////
+
+// The registry of solvers. It is zero-initialized before any
+// registrar runs during static initialization.
+
+const int MAX_SOLVERS = 16;
+
+static const ad_solver *solvers[ MAX_SOLVERS ];
+static int             nsolvers;
+
+void
+register_solver( const ad_solver *s )
+{
+    if ( MAX_SOLVERS <= nsolvers ) {
+        printf( "ERROR: Too many solvers.\n" );
+        abort();
+    }
+    solvers[ nsolvers++ ] = s;
+}  // register_solver
+
+int
+num_solvers()
+{
+    return nsolvers;
+}  // num_solvers
+
+const ad_solver *
+ith_solver( int i )
+{
+    return solvers[ i ];
+}  // ith_solver
+
+const ad_solver *
+find_solver( const char *name )
+{
+    if ( ( NULL == name ) || ( '\0' == name[ 0 ] ) ) {
+        if ( 1 == nsolvers )
+            return solvers[ 0 ];
+        name = "howard";
+    }
+    for ( int i = 0; i < nsolvers; ++i ) {
+        if ( !strcmp( solvers[ i ]->name, name ) )
+            return solvers[ i ];
+    }
+    return NULL;
+}  // find_solver
+
+///////////////////////////////////////////////////////////////////////
+
+ad_resolve_state::
+ad_resolve_state( const ad_graph< cninfo >& cg, int m )
+{
+    nsccs = cg.num_nodes();
+    scc_of_edge = new int[ m ];
+    changed = new bool[ nsccs ];
+    scc_lambda = new double[ nsccs ];
+    warm = new ad_warm_start[ nsccs ];
+    cycles = new ad_cycle[ nsccs ];
+
+    init_table( scc_of_edge, 0, m - 1, -1 );
+    for ( int v = 0; v < nsccs; ++v ) {
+        const ad_scc_view *scc = cg.node_info( v ).comp;
+        for ( int e = 0; e < scc->num_edges(); ++e )
+            scc_of_edge[ scc->graph_edge( e ) ] = v;
+    }
+
+    mark_all( false );
+}  // ad_resolve_state
+
+ad_resolve_state::
+~ad_resolve_state()
+{
+    delete [] cycles;
+    delete [] warm;
+    delete [] scc_lambda;
+    delete [] changed;
+    delete [] scc_of_edge;
+}  // ~ad_resolve_state
+
+void
+ad_resolve_state::
+mark_all( bool cold )
+{
+    init_table( changed, 0, nsccs - 1, true );
+    if ( cold ) {
+        for ( int v = 0; v < nsccs; ++v )
+            warm[ v ].nnodes = 0;
+    }
+}  // mark_all
+
+///////////////////////////////////////////////////////////////////////
+
+// SCCs with fewer edges than this are not raced: they are solved with
+// the first solver since starting threads would take longer.
+const int RACE_MIN_EDGES = 4096;
+
+// Return the numeric policy, in bits, to solve the SCC comp with: the
+// 64-bit one if plus_infinity or the total transit time of comp does
+// not fit in 32 bits, else the one of num_bits, or for NUM_AUTO, the
+// 16-bit one if the weights and transit times of comp fit in it. Set
+// unit_ttime to true if the transit times of comp are all 1, so that
+// the cycle mean instance of the policy can solve it.
+static
+int
+choose_num_bits( const ad_scc_view *comp, long long plus_infinity, int num_bits,
+                 bool& unit_ttime )
+{
+    bool fits16 = true;
+    long long total_ttime = 0;
+    unit_ttime = true;
+    for ( int e = 0; e < comp->num_edges(); ++e ) {
+        if ( SHRT_MAX < abs_val( comp->edge_info( e ) ) )
+            fits16 = false;
+        if ( SHRT_MAX < comp->edge_info2( e ) )
+            fits16 = false;
+        if ( 1 != comp->edge_info2( e ) )
+            unit_ttime = false;
+        total_ttime += comp->edge_info2( e );
+    }
+
+    if ( ( INT_MAX < plus_infinity ) || ( INT_MAX < total_ttime ) )
+        return NUM_64;
+
+    if ( NUM_AUTO == num_bits )
+        return ( fits16 ? NUM_16 : NUM_32 );
+    if ( ( NUM_16 == num_bits ) && !fits16 )
+        return NUM_32;
+    return num_bits;
+}  // choose_num_bits
+
+// Run the instance of solver for the numeric policy of num_bits on the
+// SCC g, the cycle mean one if unit_ttime is true.
+static
+double
+run_solver( const ad_solver *solver, const ad_scc_view *g, long long plus_infinity,
+            double lambda_so_far, int num_bits, bool unit_ttime, const sinfo& si )
+{
+    if ( unit_ttime ) {
+        switch ( num_bits ) {
+        case NUM_16:
+            return solver->find_min_cycle_mean_for_scc16( g, ( int ) plus_infinity,
+                                                          lambda_so_far, si );
+        case NUM_32:
+            return solver->find_min_cycle_mean_for_scc32( g, ( int ) plus_infinity,
+                                                          lambda_so_far, si );
+        default:
+            return solver->find_min_cycle_mean_for_scc64( g, plus_infinity,
+                                                          lambda_so_far, si );
+        }
+    }
+
+    switch ( num_bits ) {
+    case NUM_16:
+        return solver->find_min_cycle_ratio_for_scc16( g, ( int ) plus_infinity,
+                                                       lambda_so_far, si );
+    case NUM_32:
+        return solver->find_min_cycle_ratio_for_scc32( g, ( int ) plus_infinity,
+                                                       lambda_so_far, si );
+    default:
+        return solver->find_min_cycle_ratio_for_scc64( g, plus_infinity,
+                                                       lambda_so_far, si );
+    }
+}  // run_solver
+
+// Work shared by the threads racing solvers on an SCC. Each thread
+// takes the next solver.
+struct race_work {
+    const ad_scc_view *comp;
+    long long         plus_infinity;
+    double            lambda_so_far;
+    int               num_bits;
+    bool              unit_ttime;
+    const ad_solver   **solvers;
+    int               next;    // Next index into solvers.
+    sinfo             si;
+    ad_stop_flag      stop;
+    ad_cycle          *cycles; // The cycle found by each solver.
+    int               winner;  // The first solver to finish, or -1.
+    double            lambda;  // The lambda found by the winner.
+};
+
+static
+void *
+race_solvers( void *arg )
+{
+    race_work *w = ( race_work * ) arg;
+
+    int k = __atomic_fetch_add( &w->next, 1, __ATOMIC_RELAXED );
+    const ad_solver *solver = w->solvers[ k ];
+
+    sinfo si = w->si;
+    if ( si.cycle )
+        si.cycle = &w->cycles[ k ];
+
+    ad_scc_view scc( *w->comp, solver->add_source );
+    double lambda = run_solver( solver, &scc, w->plus_infinity, w->lambda_so_far,
+                               w->num_bits, w->unit_ttime, si );
+
+    // Only the winner sets stop, so a stopped solver cannot win.
+    int none = -1;
+    if ( __atomic_compare_exchange_n( &w->winner, &none, k, false,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+        w->lambda = lambda;
+        w->stop.set();
+    }
+
+    return NULL;
+}  // race_solvers
+
+// Find the min cycle ratio for the SCC comp by racing the solvers. The
+// cycle of the winner is put into si.cycle if it is not NULL.
+static
+double
+race_scc( const ad_scc_view *comp, long long plus_infinity, double lambda_so_far,
+          int num_bits, bool unit_ttime, const ad_solver **solvers, int nsolvers,
+          const sinfo& si )
+{
+    race_work w;
+    w.comp = comp;
+    w.plus_infinity = plus_infinity;
+    w.lambda_so_far = lambda_so_far;
+    w.num_bits = num_bits;
+    w.unit_ttime = unit_ttime;
+    w.solvers = solvers;
+    w.next = 0;
+    w.si = si;
+    w.si.stop = &w.stop;
+    w.si.warm = NULL;  // The racers would share it.
+    w.si.nthreads = 0;  // The racers already take a thread each.
+    w.cycles = ( si.cycle ? new ad_cycle[ nsolvers ] : NULL );
+    w.winner = -1;
+
+    run_threads( nsolvers, race_solvers, &w );
+
+#if PRINT_SCC
+    printf( "Race won by %s\n", solvers[ w.winner ]->name );
+#endif
+
+    if ( si.cycle ) {
+        si.cycle->copy( w.cycles[ w.winner ] );
+        delete [] w.cycles;
+    }
+
+    return w.lambda;
+}  // race_scc
+
+// Set the totals of cycle, whose edges are those of the SCC comp, and
+// renumber them as the edges of the graph of comp.
+static
+void
+map_cycle( const ad_scc_view *comp, ad_cycle *cycle )
+{
+    cycle->set_totals( comp );
+    for ( int i = 0; i < cycle->len; ++i )
+        cycle->edges[ i ] = comp->graph_edge( cycle->edges[ i ] );
+}  // map_cycle
+
+// Find the min cycle ratio for the SCC comp using solvers[0], or by
+// racing the solvers if nsolvers is more than one. If si.cycle is not
+// NULL, the critical cycle is put into it as edges of the graph of
+// comp. The numeric policy is chosen by choose_num_bits().
+static
+double
+solve_scc( const ad_scc_view *comp, long long plus_infinity, double lambda_so_far,
+           int num_bits, const ad_solver **solvers, int nsolvers, const sinfo& si )
+{
+    double lambda;
+
+    bool unit_ttime;
+    num_bits = choose_num_bits( comp, plus_infinity, num_bits, unit_ttime );
+
+    if ( ( 1 == nsolvers ) || ( comp->num_edges() < RACE_MIN_EDGES ) ) {
+        ad_scc_view scc( *comp, solvers[ 0 ]->add_source );
+        lambda = run_solver( solvers[ 0 ], &scc, plus_infinity, lambda_so_far,
+                             num_bits, unit_ttime, si );
+    } else {
+        lambda = race_scc( comp, plus_infinity, lambda_so_far, num_bits, unit_ttime,
+                           solvers, nsolvers, si );
+    }
+
+    if ( si.cycle )
+        map_cycle( comp, si.cycle );
+
+    return lambda;
+}  // solve_scc
+
+///////////////////////////////////////////////////////////////////////
+
+// Work shared by the threads solving the SCCs. Each thread takes the
+// next SCC from order until none is left.
+struct scc_work {
+    const ad_graph< cninfo > *cg;
+    long long                plus_infinity;
+    int                      num_bits;
+    const ad_solver          **solvers;
+    int                      nsolvers;
+    int                      *order;  // Nontrivial SCCs, largest first.
+    int                      norder;
+    int                      next;    // Next index into order.
+    ad_shared_lambda         *best;
+    ad_resolve_state         *rs;
+    ad_cycle                 *cycles;  // The best cycle of each thread, or NULL.
+    double                   *cycle_lambdas;
+    int                      next_thread;  // Next index into cycles.
+};
+
+// An SCC to sort by size. The size is kept with the SCC so that
+// sorting needs no global state, e.g., when a library user solves
+// several graphs at once.
+struct scc_size {
+    int m;  // Number of edges.
+    int v;  // SCC number.
+};
+
+// Compare two SCCs by decreasing number of edges, breaking ties by
+// SCC number.
+static
+int
+compare_scc_sizes( const void *x, const void *y )
+{
+    const scc_size *u = ( const scc_size * ) x;
+    const scc_size *v = ( const scc_size * ) y;
+    if ( u->m != v->m )
+        return ( u->m > v->m ? -1 : 1 );
+    return u->v - v->v;
+}  // compare_scc_sizes
+
+static
+void *
+solve_sccs( void *arg )
+{
+    scc_work *w = ( scc_work * ) arg;
+
+    // With rs, each SCC is solved on its own, for its own lambda.
+    sinfo si;
+    if ( NULL == w->rs )
+        si.best = w->best;
+
+    // Without rs, each thread keeps the cycle of the smallest lambda it
+    // finds, and the best of these is taken once all threads finish.
+    ad_cycle *best_cycle = NULL;
+    double   *best_lambda = NULL;
+    ad_cycle scc_cycle;
+    if ( w->cycles && ( NULL == w->rs ) ) {
+        int k = __atomic_fetch_add( &w->next_thread, 1, __ATOMIC_RELAXED );
+        best_cycle = &w->cycles[ k ];
+        best_lambda = &w->cycle_lambdas[ k ];
+        si.cycle = &scc_cycle;
+    }
+
+    while ( true ) {
+        int i = __atomic_fetch_add( &w->next, 1, __ATOMIC_RELAXED );
+        if ( i >= w->norder )
+            break;
+
+        int v = w->order[ i ];
+        const ad_scc_view *scc = w->cg->node_info( v ).comp;
+
+#if PRINT_SCC
+        printf( "Processing SCC # = %d with n= %d m= %d\n", 
+                v, scc->num_nodes(), scc->num_edges() );
+#endif
+
+        double lambda_for_scc;
+        if ( w->rs ) {
+            si.warm = &w->rs->warm[ v ];
+            si.cycle = &w->rs->cycles[ v ];
+            lambda_for_scc = solve_scc( scc, w->plus_infinity, ( double ) w->plus_infinity,
+                                        w->num_bits, w->solvers, w->nsolvers, si );
+            w->rs->scc_lambda[ v ] = lambda_for_scc;
+            w->rs->changed[ v ] = false;
+        } else {
+            lambda_for_scc = solve_scc( scc, w->plus_infinity, w->best->get(),
+                                        w->num_bits, w->solvers, w->nsolvers, si );
+            if ( best_cycle && ( lambda_for_scc < *best_lambda ) ) {
+                *best_lambda = lambda_for_scc;
+                best_cycle->copy( scc_cycle );
+            }
+        }
+        w->best->lower( lambda_for_scc );
+
+#if PRINT_SCC
+        printf( "Lambda for SCC# %d is %10.2f\n", v, lambda_for_scc );
+#endif
+    }
+
+    return NULL;
+}  // solve_sccs
+
+// Return true if the SCC v of cg is to be solved: it has edges, and if
+// there is rs, it is marked in rs.
+static
+bool
+is_to_solve( const ad_graph< cninfo >& cg, int v, const ad_resolve_state *rs )
+{
+    return cg.node_info( v ).comp->num_edges() && ( ( NULL == rs ) || rs->changed[ v ] );
+}  // is_to_solve
+
+double
+find_min_cycle_ratio_for_components( const ad_graph< cninfo >& cg,
+                                     long long plus_infinity,
+                                     const ad_solver **solvers,
+                                     int nsolvers,
+                                     int nthreads,
+                                     ad_resolve_state *rs,
+                                     ad_cycle *cycle,
+                                     int num_bits )
+{
+    double lambda = ( double ) plus_infinity;
+
+    if ( cycle )
+        cycle->reset( 0 );
+
+    // With only one SCC to solve, the threads go to its solver instead.
+    int nsolve = 0;
+    for ( int v = 0; v < cg.num_nodes(); ++v ) {
+        if ( is_to_solve( cg, v, rs ) )
+            ++nsolve;
+    }
+
+    if ( ( 1 < nthreads ) && ( 1 < nsolve ) ) {
+        scc_size *sizes = new scc_size[ cg.num_nodes() ];
+        int norder = 0;
+        for ( int v = 0; v < cg.num_nodes(); ++v ) {
+            if ( is_to_solve( cg, v, rs ) ) {
+                sizes[ norder ].m = cg.node_info( v ).comp->num_edges();
+                sizes[ norder ].v = v;
+                ++norder;
+            }
+        }
+
+        // Start the largest SCCs first so that the last SCC to finish
+        // is a small one.
+        qsort( sizes, norder, sizeof( scc_size ), compare_scc_sizes );
+
+        int *order = new int[ norder ];
+        for ( int i = 0; i < norder; ++i )
+            order[ i ] = sizes[ i ].v;
+        delete [] sizes;
+
+        ad_shared_lambda best( lambda );
+
+        nthreads = min( nthreads, norder );
+
+        scc_work w;
+        w.cg = &cg;
+        w.plus_infinity = plus_infinity;
+        w.num_bits = num_bits;
+        w.solvers = solvers;
+        w.nsolvers = nsolvers;
+        w.order = order;
+        w.norder = norder;
+        w.next = 0;
+        w.best = &best;
+        w.rs = rs;
+        w.cycles = NULL;
+        w.cycle_lambdas = NULL;
+        w.next_thread = 0;
+        if ( cycle ) {
+            w.cycles = new ad_cycle[ nthreads ];
+            w.cycle_lambdas = new double[ nthreads ];
+            init_table( w.cycle_lambdas, 0, nthreads - 1, lambda );
+        }
+
+        run_threads( nthreads, solve_sccs, &w );
+
+        delete [] order;
+
+        lambda = best.get();
+
+        // Take the cycle of a thread that found lambda. A thread that
+        // stopped at the lambda of another thread has no cycle for it.
+        if ( cycle && ( NULL == rs ) ) {
+            for ( int k = 0; k < nthreads; ++k ) {
+                if ( ( w.cycle_lambdas[ k ] == lambda ) && ( 0 < w.cycles[ k ].len ) ) {
+                    cycle->copy( w.cycles[ k ] );
+                    break;
+                }
+            }
+        }
+        delete [] w.cycle_lambdas;
+        delete [] w.cycles;
+
+    } else {
+
+        sinfo    si;
+        ad_cycle scc_cycle;
+        if ( cycle && ( NULL == rs ) )
+            si.cycle = &scc_cycle;
+        si.nthreads = ( 1 == nsolve ? nthreads : 0 );
+
+        for ( int v = 0; v < cg.num_nodes(); ++v ) {
+
+            if ( !is_to_solve( cg, v, rs ) )
+                continue;
+
+            const ad_scc_view *scc = cg.node_info( v ).comp;
 
 #if PRINT_SCC
             // Only print info for non-trivial SCCs.
@@ -1179,7 +3086,22 @@ find_min_cycle_ratio_for_components( const ad_graph< cninfo >& cg,
                     v, scc->num_nodes(), scc->num_edges() );
 #endif
 
-            float lambda_for_scc = find_min_cycle_ratio_for_scc( scc, plus_infinity, lambda );
+            // With rs, each SCC is solved on its own, for its own
+            // lambda.
+            double lambda_for_scc;
+            if ( rs ) {
+                si.warm = &rs->warm[ v ];
+                si.cycle = &rs->cycles[ v ];
+                lambda_for_scc = solve_scc( scc, plus_infinity, ( double ) plus_infinity,
+                                            num_bits, solvers, nsolvers, si );
+                rs->scc_lambda[ v ] = lambda_for_scc;
+                rs->changed[ v ] = false;
+            } else {
+                lambda_for_scc = solve_scc( scc, plus_infinity, lambda, 
+                                            num_bits, solvers, nsolvers, si );
+                if ( cycle && ( lambda_for_scc < lambda ) )
+                    cycle->copy( scc_cycle );
+            }
             min2( lambda, lambda_for_scc );
 
 #if PRINT_SCC
@@ -1191,14 +3113,182 @@ find_min_cycle_ratio_for_components( const ad_graph< cninfo >& cg,
             printf( "New lambda= %10.2f\n", lambda );
 #endif
 
-        }  // if
-    }  // for
+        }  // for
+    }
+
+    // The SCCs not solved again keep their lambdas and cycles.
+    if ( rs ) {
+        lambda = ( double ) plus_infinity;
+        int best_scc = -1;
+        for ( int v = 0; v < cg.num_nodes(); ++v ) {
+            if ( cg.node_info( v ).comp->num_edges() && ( rs->scc_lambda[ v ] < lambda ) ) {
+                lambda = rs->scc_lambda[ v ];
+                best_scc = v;
+            }
+        }
+        if ( cycle && ( -1 != best_scc ) )
+            cycle->copy( rs->cycles[ best_scc ] );
+    }
 
     return lambda;
 }  // find_min_cycle_ratio_for_components
 
 ///////////////////////////////////////////////////////////////////////
 
+// More node info for the exact verification.
+struct ninfo_exact {
+    __int128  dist;     // node distance.
+    int       pred;     // the edge from the predecessor node, or -1.
+    int       visited;  // set if visited for some purpose.
+    bool      in_q;     // set if in the node queue.
+};
+
+// Find a cycle of the pred edges in more_ninfo into cycle if its ratio
+// is less than w / t; otherwise, empty cycle.
+static
+void
+find_pred_cycle( const ad_scc_view *g, ninfo_exact *more_ninfo, 
+                 long long w, long long t, ad_cycle *cycle )
+{
+    int n = g->num_nodes();
+
+    for ( int v = 0; v < n; ++v )
+        more_ninfo[ v ].visited = -1;
+
+    for ( int v = 0; v < n; ++v ) {
+
+        if ( 0 <= more_ninfo[ v ].visited )
+            continue;
+
+        // Search for a new cycle. visited[u] shows from which node the
+        // search started.
+        int u = v;
+        do {
+            more_ninfo[ u ].visited = v;
+            u = ( -1 == more_ninfo[ u ].pred ? -1 : g->source( more_ninfo[ u ].pred ) );
+        } while ( ( -1 != u ) && ( -1 == more_ninfo[ u ].visited ) );
+
+        if ( ( -1 == u ) || ( v != more_ninfo[ u ].visited ) )
+            continue;
+
+        // The node u is on the cycle. Collect its edges backwards.
+        cycle->reset( n );
+        int x = u;
+        do {
+            int e = more_ninfo[ x ].pred;
+            cycle->add( e );
+            x = g->source( e );
+        } while ( x != u );
+        cycle->reverse();
+
+        cycle->set_totals( g );
+        if ( cycle->is_below( w, t ) )
+            return;
+    }
+
+    cycle->reset( n );
+}  // find_pred_cycle
+
+// Find a cycle of the SCC g whose ratio is less than w / t, where t is
+// positive, into cycle, or empty cycle if there is none. This is
+// Bellman-Ford's algorithm in integers with the edge weights t * w(e) -
+// w * t(e), from a virtual source connected to every node, so no
+// rounding can hide such a cycle. As in Szymanski's algorithm, the pred
+// edges are checked for a cycle every so often (every n node visits).
+// The dists are 128-bit: an edge weight is less than 2^95 in magnitude
+// since w and t are 64-bit and w(e) and t(e) are 32-bit, so a dist
+// overflows only after far more edge relaxations than are ever done;
+// abort if one does rather than miss or invent a cycle.
+static
+void
+find_cycle_below( const ad_scc_view *g, long long w, long long t, ad_cycle *cycle )
+{
+    int n = g->num_nodes();
+
+    ninfo_exact      *more_ninfo = new ninfo_exact[ n ];
+    ad_cqueue< int > nodeq( n );
+
+    cycle->reset( n );
+
+    nodeq.init();
+    for ( int v = 0; v < n; ++v ) {
+        more_ninfo[ v ].dist = 0;
+        more_ninfo[ v ].pred = -1;
+        more_ninfo[ v ].in_q = true;
+        nodeq.put( v );
+    }
+
+    int nvisits = 0;
+    while ( nodeq.is_not_empty() ) {
+        int u = nodeq.get();
+        more_ninfo[ u ].in_q = false;
+
+        __int128 udist = more_ninfo[ u ].dist;
+        for ( int i = 0; i < g->outdegree( u ); ++i ) {
+            int v = g->ith_target_node( u, i );
+            __int128 new_dist;
+            if ( __builtin_add_overflow( udist, ( __int128 ) t * g->ith_target_edge_info( u, i ) -
+                                         ( __int128 ) w * g->ith_target_edge_info2( u, i ), &new_dist ) ) {
+                printf( "ERROR: A dist overflows in the exact verification.\n" );
+                abort();
+            }
+            if ( new_dist < more_ninfo[ v ].dist ) {
+                more_ninfo[ v ].dist = new_dist;
+                more_ninfo[ v ].pred = g->ith_target_edge( u, i );
+                if ( ! more_ninfo[ v ].in_q ) {
+                    more_ninfo[ v ].in_q = true;
+                    nodeq.put( v );
+                }
+            }
+        }
+
+        if ( ++nvisits == n ) {
+            nvisits = 0;
+            find_pred_cycle( g, more_ninfo, w, t, cycle );
+            if ( cycle->len )
+                break;
+        }
+    }  // while
+
+    delete [] more_ninfo;
+}  // find_cycle_below
+
+int
+verify_min_cycle_ratio_for_components( const ad_graph< cninfo >& cg,
+                                       long long plus_infinity,
+                                       ad_cycle& cycle )
+{
+    int nruns = 0;
+    ad_cycle scc_cycle;
+
+    for ( int v = 0; v < cg.num_nodes(); ++v ) {
+        const ad_scc_view *scc = cg.node_info( v ).comp;
+        if ( 0 == scc->num_edges() )
+            continue;
+
+        // A cycle of the SCC with a smaller ratio, if any, becomes the
+        // cycle to verify. The SCCs before v have no cycle with a ratio
+        // smaller than the old cycle, so they need not be checked again.
+        // If there is no cycle yet, any cycle has a ratio less than
+        // plus_infinity.
+        while ( true ) {
+            ++nruns;
+            if ( cycle.len )
+                find_cycle_below( scc, cycle.total_weight, cycle.total_length, &scc_cycle );
+            else
+                find_cycle_below( scc, plus_infinity, 1, &scc_cycle );
+            if ( 0 == scc_cycle.len )
+                break;
+            map_cycle( scc, &scc_cycle );
+            cycle.copy( scc_cycle );
+        }
+    }
+
+    return nruns;
+}  // verify_min_cycle_ratio_for_components
+
+///////////////////////////////////////////////////////////////////////
+
 // Instantiate instances of ad_graph with info types.
 template class ad_graph< ninfo >;
 template class ad_graph< cninfo >;
@@ -4,11 +4,25 @@
 #ifndef AD_GRAPH_INCLUDED
 #define AD_GRAPH_INCLUDED
 
+#include <limits.h>
+
 #include "ad_globals.h"
+#include "ad_thread.h"
+#include "ad_util.h"
 
 // Forward declarations.
 struct ginfo;
 template< class ninfo_t > class ad_graph;
+class ad_scc_view;
+
+// Return true if w can be an edge weight. The weights are negated for
+// the max version, so INT_MIN cannot.
+inline
+bool
+is_weight_valid( long long w )
+{
+    return ( -INT_MAX <= w ) && ( w <= INT_MAX );
+}  // is_weight_valid
 
 ///////////////////////////////////////////////////////////////////////
 // Node class:
@@ -21,40 +35,7 @@ class ad_node {
 
 public:
 
-    // Constructors:
-    ad_node() 
-    { 
-        set_node( 0, 0, -1, -1 );
-    }
-#if 0
-    ad_node( int id, int od, int ia, int oa )
-    {
-        set_node( id, od, ia, oa );
-    }
-#endif
-
     // Get and set functions:
-    int indegree() const
-    {
-        return indeg;
-    }
-    void indegree( int d )
-    {
-        indeg = d;
-    }
-    int outdegree() const
-    {
-        return outdeg;
-    }
-    void outdegree( int d )
-    {
-        outdeg = d;
-    }
-    int degree() const
-    {
-        return indeg + outdeg;
-    }
-
     ninfo_t info() const
     {
         return inf;
@@ -72,361 +53,27 @@ public:
     }
 
 private:
-    int     indeg;  // In-degree.
-    int     outdeg; // Out-degree.
-    int     inadj;  // Index of the first edge in adjlist array.
-    int     outadj; // Index of the first edge out adjlist array.
     ninfo_t inf;    // Info field.
-
-    // Constructor helpers.
-    void set_node( int id, int od, int ia, int oa )
-    {
-        indeg = id; outdeg = od; inadj = ia; outadj = oa;
-    }
-
-    // To get and set the first edge in- or out-index:
-    int first_inedge() const
-    {
-        return inadj;
-    }
-    void first_inedge( int a )
-    {
-        inadj = a;
-    }
-    int first_outedge() const
-    {
-        return outadj;
-    }
-    void first_outedge( int a )
-    {
-        outadj = a;
-    }
-
-    // Increment in- and out-degree:
-    void inc_indegree()
-    {
-        ++indeg;
-    }
-    void inc_outdegree()
-    {
-        ++outdeg;
-    }
 };  // ad_node
 
 ///////////////////////////////////////////////////////////////////////
-// Edge class: ( I use the terms arc and edge interchangeably. )
-
-class ad_edge {
-
-    template< class ninfo_t >
-    friend class ad_graph;
-
-public:
-
-    // Constructors:
-    ad_edge()
-    {
-#ifdef DEBUG
-        set_edge( -1, -1 );
-#endif
-    }
-#if 0
-    ad_edge( int s, int t )
-    {
-        set_edge( s, t );
-    }
-#endif
-
-    // Get and set functions:
-    int source() const
-    {
-        return src;
-    }
-    void source( int s )
-    {
-        src = s;
-    }
-
-    int target() const
-    {
-        return tar;
-    }
-    void target( int t )
-    {
-        tar = t;
-    }
-
-    int info() const
-    {
-        return inf;
-    }
-    void info( int ei )
-    {
-        inf = ei;
-    }
-
-#ifdef CYCLE_MEAN_VERSION
-    // Printing the info fields.
-    void print_info() const
-    {
-        printf( "%d %d", inf, inf2 );
-    }
-#else
-    int info2() const
-    {
-        return inf2;
-    }
-    void info2( int ei2 )
-    {
-        inf2 = ei2;
-    }
-    void info( int ei, int ei2 )
-    {
-        inf = ei; inf2 = ei2;
-    }
-
-    // Printing the info fields.
-    void print_info() const
-    {
-        printf( "%d %d", inf, inf2 );
-    }
-#endif
-
-private:
-    // Edge is src -> tar with info inf and inf2.
-    int  src;  
-    int  tar;
-    int  inf;
-#ifndef CYCLE_MEAN_VERSION
-    int  inf2;
-#endif
-
-    // Constructor helper.
-    void set_edge( int s, int t ) 
-    {
-        src = s; tar = t; 
-    }
-};  // ad_edge
-
-///////////////////////////////////////////////////////////////////////
-// InEdge class: ( I use the terms arc and edge interchangeably. )
-
-class ad_inedge {
-
-    template< class ninfo_t >
-    friend class ad_graph;
-
-public:
-
-    // Constructors:
-    ad_inedge()
-    {
-#ifdef DEBUG
-        ine = -1;
-#endif
-    }
-
-#ifdef CYCLE_MEAN_VERSION
-    // Constructor helper.
-    void set_edge( int e, int s, int ei ) 
-    {
-        ine = e; src = s; inf = ei;
-    }
-#else
-    // Constructor helper.
-    void set_edge( int e, int s, int ei, int ei2 ) 
-    {
-        ine = e; src = s; inf = ei; inf2 = ei2;
-    }
-#endif
-
-    // Get and set functions:
-    int source_edge() const
-    {
-        return ine;
-    }
-    void source_edge( int e )
-    {
-        ine = e;
-    }
-
-    int source() const
-    {
-        return src;
-    }
-    void source( int s )
-    {
-        src = s;
-    }
-
-    int info() const
-    {
-        return inf;
-    }
-    void info( int ei )
-    {
-        inf = ei;
-    }
-
-#ifdef CYCLE_MEAN_VERSION
-    // Printing the info field.
-    void print_info() const
-    {
-        printf( "%d", inf );
-    }
-#else
-    int info2() const
-    {
-        return inf2;
-    }
-    void info2( int ei2 )
-    {
-        inf2 = ei2;
-    }
-    void info( int ei, int ei2 )
-    {
-        inf = ei; inf2 = ei2;
-    }
-
-    // Printing the info fields.
-    void print_info() const
-    {
-        printf( "%d %d", inf, inf2 );
-    }
-#endif
-
-private:
-    // Except ine (src, tar), the rest of the data members below are
-    // redundant. They are included for efficiency in that accessing an
-    // inedge of a node tar (which is supposed to point to here) can
-    // also return the attributes of the inedge itself w/o a subsequent
-    // access to the edge array (or list).
-    int ine;
-    int src;  
-    int inf;
-#ifndef CYCLE_MEAN_VERSION
-    int inf2;
-#endif
-
-    // Disable these functions.
-    int target_edge() const;
-    void target_edge( int e );
-    int target() const;
-    void target( int t );
-};  // ad_inedge
-
-///////////////////////////////////////////////////////////////////////
-// Outedge class: ( I use the terms arc and edge interchangeably. )
-
-class ad_outedge {
-
-    template< class ninfo_t >
-    friend class ad_graph;
-
-public:
-
-    // Constructors:
-    ad_outedge()
-    {
-#ifdef DEBUG
-        oute = -1;
-#endif
-    }
-
-#ifdef CYCLE_MEAN_VERSION
-    // Constructor helper.
-    void set_edge( int e, int t, int ei ) 
-    {
-        oute = e; tar = t; inf = ei;
-    }
-#else
-    // Constructor helper.
-    void set_edge( int e, int t, int ei, int ei2 ) 
-    {
-        oute = e; tar = t; inf = ei; inf2 = ei2;
-    }
-#endif
-
-    // Get and set functions:
-    int target_edge() const
-    {
-        return oute;
-    }
-    void target_edge( int e )
-    {
-        oute = e;
-    }
-
-    int target() const
-    {
-        return tar;
-    }
-    void target( int t )
-    {
-        tar = t;
-    }
-
-    int info() const
-    {
-        return inf;
-    }
-    void info( int ei )
-    {
-        inf = ei;
-    }
-
-#ifdef CYCLE_MEAN_VERSION
-    // Printing the info field.
-    void print_info() const
-    {
-        printf( "%d", inf );
-    }
-#else
-    int info2() const
-    {
-        return inf2;
-    }
-    void info2( int ei2 )
-    {
-        inf2 = ei2;
-    }
-    void info( int ei, int ei2 )
-    {
-        inf = ei; inf2 = ei2;
-    }
-
-    // Printing the info field.
-    void print_info() const
-    {
-        printf( "%d %d", inf, inf2 );
-    }
-#endif
-
-private:
-    // Except oute (src, tar), the rest of the data members below are
-    // redundant. They are included for efficiency in that accessing an
-    // outedge of a node src (which is supposed to point to here) can
-    // also return the attributes of the outedge itself w/o a subsequent
-    // access to the edge array (or list).
-    int oute;
-    int tar;  
-    int inf;
-#ifndef CYCLE_MEAN_VERSION
-    int inf2;
-#endif
-
-    // Disable these functions.
-    int source_edge() const;
-    void source_edge( int e );
-    int source() const;
-    void source( int s );
-};  // ad_outedge
-
-///////////////////////////////////////////////////////////////////////
-// Graph class: 
+// Graph class:
+//
+// The edges and the adjacency lists are kept as structures of arrays
+// rather than arrays of structures. Edge e is esrc[e] -> etar[e] with
+// weight einf[e] and transit time einf2[e]. The adjacency lists are in
+// the compressed sparse row (CSR) form: the outedges of node v are at
+// out_first[v], ..., out_first[v+1]-1 of the out_* arrays, and its
+// inedges are at in_first[v], ..., in_first[v+1]-1 of the in_*
+// arrays. Each adjacency entry repeats the weight and transit time of
+// its edge so that a scan over the outedges (or inedges) of a node
+// touches only the arrays it needs and never the edge arrays.
 
 template< class ninfo_t >
 class ad_graph {
+
+    friend class ad_scc_view;
+
 public:
 
     // Constructors:
@@ -457,35 +104,28 @@ public:
         return nedges;
     }
 
-    // Get and set functions for the nodes and edges:
+    // Get and set functions for the nodes and edges. The degrees are
+    // valid only after build_adj is called.
     int degree( int v ) const
     {
         return indegree( v ) + outdegree( v );
     }
     int indegree( int v ) const
     {
-        return nlist[ v ].indegree();
-    }
-    void indegree( int v, int d ) 
-    {
-        nlist[ v ].indegree( d );
+        return in_first[ v + 1 ] - in_first[ v ];
     }
     int outdegree( int v ) const
     {
-        return nlist[ v ].outdegree();
-    }
-    void outdegree( int v, int d )
-    {
-        nlist[ v ].outdegree( d );
+        return out_first[ v + 1 ] - out_first[ v ];
     }
 
     int source( int e ) const
     {
-        return elist[ e ].source();
+        return esrc[ e ];
     }
     int target( int e ) const
     {
-        return elist[ e ].target();
+        return etar[ e ];
     }
 
     ninfo_t node_info( int v ) const
@@ -499,76 +139,62 @@ public:
     }
     int edge_info( int e ) const
     {
-        return elist[ e ].info();
+        return einf[ e ];
     }
     int edge_info( int e, int ei )
     {
-        elist[ e ].info( ei );
+        einf[ e ] = ei;
         return e;
     }
 
-#ifndef CYCLE_MEAN_VERSION
     int edge_info2( int e ) const
     {
-        return elist[ e ].info2();
+        return einf2[ e ];
     }
     int edge_info2( int e, int ei2 )
     {
-        elist[ e ].info2( ei2 );
+        einf2[ e ] = ei2;
         return e;
     }
     int edge_info( int e, int ei, int ei2 )
     {
-        elist[ e ].info( ei, ei2 );
+        einf[ e ] = ei;
+        einf2[ e ] = ei2;
         return e;
     }
-#endif
 
     int ith_source_node( int v, int i ) const
     {
-        return inlist[ nlist[ v ].first_inedge() + i ].source();
+        return in_src[ in_first[ v ] + i ];
     }
     int ith_source_edge( int v, int i ) const
     {
-        return inlist[ nlist[ v ].first_inedge() + i ].source_edge();
+        return in_edge[ in_first[ v ] + i ];
     }
     int ith_source_edge_info( int v, int i ) const
     {
-        return inlist[ nlist[ v ].first_inedge() + i ].info();
+        return in_inf[ in_first[ v ] + i ];
     }
-#ifndef CYCLE_MEAN_VERSION
     int ith_source_edge_info2( int v, int i ) const
     {
-        return inlist[ nlist[ v ].first_inedge() + i ].info2();
-    }
-#endif
-    ad_inedge ith_source( int v, int i ) const
-    {
-        return inlist[ nlist[ v ].first_inedge() + i ];
+        return in_inf2[ in_first[ v ] + i ];
     }
 
     int ith_target_node( int v, int i ) const
     {
-        return outlist[ nlist[ v ].first_outedge() + i ].target();
+        return out_tar[ out_first[ v ] + i ];
     }
     int ith_target_edge( int v, int i ) const
     {
-        return outlist[ nlist[ v ].first_outedge() + i ].target_edge();
+        return out_edge[ out_first[ v ] + i ];
     }
     int ith_target_edge_info( int v, int i ) const
     {
-        return outlist[ nlist[ v ].first_outedge() + i ].info();
+        return out_inf[ out_first[ v ] + i ];
     }
-#ifndef CYCLE_MEAN_VERSION
     int ith_target_edge_info2( int v, int i ) const
     {
-        return outlist[ nlist[ v ].first_outedge() + i ].info2();
-    }
-#endif
-
-    ad_outedge ith_target( int v, int i ) const
-    {
-        return outlist[ nlist[ v ].first_outedge() + i ];
+        return out_inf2[ out_first[ v ] + i ];
     }
 
 #if 0
@@ -582,6 +208,17 @@ public:
     }
 #endif
 
+    // Return the number of node v or edge e before the graph was
+    // renumbered by sort_by_components.
+    int orig_node( int v ) const
+    {
+        return ( node_orig ? node_orig[ v ] : v );
+    }
+    int orig_edge( int e ) const
+    {
+        return ( edge_orig ? edge_orig[ e ] : e );
+    }
+
     // Return true if the nodes u and v are adjacent; false
     // otherwise. The fast version can only be called after build_adj is
     // called. The slow version is okay to call any time.
@@ -612,33 +249,26 @@ public:
     // Insert a node and return its number.
     int ins_node()
     {
-        nlist[ ++cur_node ].set_node( 0, 0, -1, -1 );
-        return cur_node;
+        return ++cur_node;
     }
     int ins_node( const ninfo_t& ni )
     {
         return node_info( ins_node(), ni );
     }
 
-    // Insert an edge and return its number.
+    // Insert an edge and return its number. The degrees of s and t are
+    // counted later by build_adj.
     int ins_edge( int s, int t )
     {
-        elist[ ++cur_edge ].set_edge( s, t );
-        inc_outdegree( s );
-        inc_indegree( t );
+        ++cur_edge;
+        esrc[ cur_edge ] = s;
+        etar[ cur_edge ] = t;
         return cur_edge;
     }
-#ifdef CYCLE_MEAN_VERSION
-    int ins_edge( int s, int t, int ei )
-    {
-        return edge_info( ins_edge( s, t ), ei );
-    }
-#else
     int ins_edge( int s, int t, int ei, int ei2 )
     {
         return edge_info( ins_edge( s, t ), ei, ei2 );
     }
-#endif
 
     // I/O functions:
 
@@ -646,16 +276,34 @@ public:
     // least one self-loop. If min_version is false, every edge weight
     // is negated in order to compute the max cycle mean. The graph is
     // either read from file_name or generated partially or completely.
-    void read( ginfo& gi, const args_t& args );
+    // The file is either in DIMACS format or in the binary format
+    // written by fprint (see ad_graph.cc). Return false, after printing
+    // an error, if the file cannot be read or is malformed.
+    bool read( ginfo& gi, const args_t& args );
     void generate_part( ginfo& gi, const args_t& args );
     void generate_all( ginfo& gi, const args_t& args );
 
+    // Build the graph with nodes 0, ..., n-1 from arrays: edge e is
+    // src[e] -> tar[e] with weight wgt[e] and transit time ttime[e], or
+    // 1 if ttime is NULL. The weights are used as read() uses the
+    // weights in a file. Return false if a node is out of range, or a
+    // weight is INT_MIN or out of the range of int after args.offset.
+    bool build( ginfo& gi, const args_t& args, int n, int m, 
+                const int *src, const int *tar, const int *wgt, const int *ttime );
+
+    // Print the graph to the screen, or to args.dump_file in the format
+    // given by args.bin_format. The weights are printed unnegated.
     void print( bool all_out = true ) const;
     void fprint( const args_t& args ) const;
 
     // Build the adjacency info.
     void build_adj();
 
+    // Copy the edge weights and transit times into the adjacency
+    // arrays. Needed after the edge info is changed via edge_info()
+    // once the adjacency info is built.
+    void sync_adj_info();
+
     // Functions to set num_nodes and num_edges during incremental
     // creation of the nodes and edges.
     void set_num_nodes( int n )
@@ -685,14 +333,43 @@ public:
             nlist = new ad_node<ninfo_t>[ nnodes ];
 
         if ( must_alloc_elist ) {
-            elist = new ad_edge[ nedges ];
-            inlist = new ad_inedge[ nedges ];
-            outlist = new ad_outedge[ nedges ];
+            esrc = new int[ nedges ];
+            etar = new int[ nedges ];
+            einf = new int[ nedges ];
+            einf2 = new int[ nedges ];
+            alloc_adj();
         }
     }  // alloc_lists
 
+    void alloc_adj()
+    {
+        in_first = new int[ nnodes + 1 ];
+        in_src = new int[ nedges ];
+        in_edge = new int[ nedges ];
+        in_inf = new int[ nedges ];
+
+        out_first = new int[ nnodes + 1 ];
+        out_tar = new int[ nedges ];
+        out_edge = new int[ nedges ];
+        out_inf = new int[ nedges ];
+
+        in_inf2 = new int[ nedges ];
+        out_inf2 = new int[ nedges ];
+    }  // alloc_adj
+
     void print_no_duplicates( bool min_version );
 
+    // Renumber the nodes and edges such that the nodes of component k
+    // (as given in comp_num) become node_first[k], ...,
+    // node_first[k+1]-1 and the edges inside component k become
+    // edge_first[k], ..., edge_first[k+1]-1. The edges between
+    // components follow, starting at edge_first[ncomps]. The relative
+    // order of the nodes and edges is kept. The adjacency info is
+    // rebuilt such that the edges inside a component come first in
+    // every adjacency list.
+    void sort_by_components( const int *comp_num, int ncomps, 
+                             int *node_first, int *edge_first );
+
 private:
     int nnodes;  // Number of nodes.
     int nedges;  // Number of edges.
@@ -702,47 +379,62 @@ private:
 
     bool not_already_built; // To control allocation of lists.
 
-    // Node, edge, and adjacency arrays ( inlist is for incoming edges
-    // whereas outlist is for outcoming edges ).
-    ad_node<ninfo_t>   *nlist;    
-    ad_edge            *elist;    
-    ad_inedge          *inlist;  
-    ad_outedge         *outlist;  
+    // Node array.
+    ad_node<ninfo_t>   *nlist;
+
+    // Edge arrays.
+    int *esrc;       // Source node.
+    int *etar;       // Target node.
+    int *einf;       // Weight.
+    int *einf2;      // Transit time.
+
+    // Inedge adjacency arrays ( n + 1 heads, m entries ).
+    int *in_first;   // Index of the first inedge of each node.
+    int *in_src;     // Source node of the inedge.
+    int *in_edge;    // Edge number of the inedge.
+    int *in_inf;     // Weight of the inedge.
+    int *in_inf2;    // Transit time of the inedge.
+
+    // Outedge adjacency arrays ( n + 1 heads, m entries ).
+    int *out_first;  // Index of the first outedge of each node.
+    int *out_tar;    // Target node of the outedge.
+    int *out_edge;   // Edge number of the outedge.
+    int *out_inf;    // Weight of the outedge.
+    int *out_inf2;   // Transit time of the outedge.
+
+    // Set by sort_by_components: the index of the first adjacency
+    // entry of each node that goes to another component, and the node
+    // and edge numbers before renumbering.
+    int *in_split;
+    int *out_split;
+    int *node_orig;
+    int *edge_orig;
+
+    // The file loaded by read_binary. The edge and adjacency arrays
+    // may point into it rather than to the heap.
+    char   *mapped;
+    size_t mapped_size;
 
 private:
-    // Get and set functions for the head pointer for the in- and
-    // out-lists:
-    int first_inedge( int v ) const
-    {
-        return nlist[ v ].first_inedge();
-    }
-    void first_inedge( int v, int ia )
-    {
-        nlist[ v ].first_inedge( ia );
-    }
+    // Load the graph from a file in the binary format. Return false
+    // as read() does.
+    bool read_binary( ginfo& gi, const args_t& args, char *data, size_t size );
 
-    int first_outedge( int v ) const
-    {
-        return nlist[ v ].first_outedge();
-    }
-    void first_outedge( int v, int oa )
-    {
-        nlist[ v ].first_outedge( oa );
-    }
+    // Turn the weights read from a file into edge weights as explained
+    // for read(), and set gi. Return false if a weight is INT_MIN or
+    // out of the range of int, e.g., after args.offset.
+    bool set_weights( ginfo& gi, const args_t& args );
 
-    // Increment in-, out-, and inout-degrees of nodes:
-    void inc_inoutdegree( int e )
-    {
-        inc_outdegree( source( e ) );
-        inc_indegree( target( e ) );
-    }
-    void inc_indegree( int v )
-    {
-        nlist[ v ].inc_indegree();
-    }
-    void inc_outdegree( int v )
+    void fprint_binary( FILE *fp, const args_t& args ) const;
+
+    // Move edge e of an edge array to new_edge[e].
+    void permute_edges( int *&ptr, const int *new_edge );
+
+    // Free an array unless it is in the mapped file.
+    void free_table( int *ptr )
     {
-        nlist[ v ].inc_outdegree();
+        if ( ( ( char * ) ptr < mapped ) || ( mapped + mapped_size <= ( char * ) ptr ) )
+            delete [] ptr;
     }
 
     // Update num_nodes and num_edges, and prevent further updates.
@@ -767,13 +459,19 @@ private:
 
         not_already_built = true;
 
+        in_split = out_split = NULL;
+        node_orig = edge_orig = NULL;
+        mapped = NULL;
+        mapped_size = 0;
+
         if ( nnodes ) {
             alloc_lists();
         } else {
             nlist = NULL;
-            elist = NULL;
-            inlist = NULL;
-            outlist = NULL;
+            esrc = etar = einf = NULL;
+            in_first = in_src = in_edge = in_inf = NULL;
+            out_first = out_tar = out_edge = out_inf = NULL;
+            einf2 = in_inf2 = out_inf2 = NULL;
         }
     }  // create
 
@@ -781,10 +479,26 @@ private:
     void clear() {
         if ( nnodes ) {
             delete [] nlist;
-            delete [] elist;
-            delete [] inlist;
-            delete [] outlist;
+            free_table( esrc );
+            free_table( etar );
+            free_table( einf );
+            free_table( in_first );
+            free_table( in_src );
+            free_table( in_edge );
+            free_table( in_inf );
+            free_table( out_first );
+            free_table( out_tar );
+            free_table( out_edge );
+            free_table( out_inf );
+            free_table( einf2 );
+            free_table( in_inf2 );
+            free_table( out_inf2 );
         }
+        delete [] in_split;
+        delete [] out_split;
+        delete [] node_orig;
+        delete [] edge_orig;
+        unmap_file( mapped, mapped_size );
     }  // clear
 
 };  // ad_graph
@@ -792,13 +506,12 @@ private:
 ///////////////////////////////////////////////////////////////////////
 // Information classes:
 
-// Graph information.
+// Graph information. The totals are 64-bit so that they cannot
+// overflow on large graphs with large weights.
 struct ginfo {
-    int  total_edge_weight;
-#ifndef CYCLE_MEAN_VERSION
-    int  total_trans_time;
-#endif
-    bool has_self_loop;
+    long long total_edge_weight;
+    long long total_trans_time;
+    bool      has_self_loop;
 };
 
 // Node information.
@@ -809,6 +522,208 @@ struct ninfo {
     }
 };
 
+///////////////////////////////////////////////////////////////////////
+// SCC view class:
+//
+// A view of one SCC of a graph that is sorted by sort_by_components. A
+// view does not copy anything: its accessors point into the CSR arrays
+// of the graph and renumber the nodes and edges of the SCC from 0 on
+// the fly. If the view has a source node, the source node is numbered
+// 0, has no edges, and the other nodes are shifted by one. The source
+// node is needed for Karp-Orlin and Young-Tarjan-Orlin algorithms, so
+// a view with a source node is made for their solvers.
+
+class ad_scc_view {
+public:
+
+    // Constructor: view the nodes node_first, ..., node_first+n-1 and
+    // the edges edge_first, ..., edge_first+m-1 of g.
+    ad_scc_view( ad_graph< ninfo >& g, int node_first, int n,
+                 int edge_first, int m, bool add_source )
+    {
+        shift = ( add_source ? 1 : 0 );
+        delta = node_first - shift;
+        efirst = edge_first;
+        nnodes = n + shift;
+        nedges = m;
+
+        esrc = g.esrc;
+        etar = g.etar;
+        einf = g.einf;
+        in_first = g.in_first;
+        in_src = g.in_src;
+        in_edge = g.in_edge;
+        in_inf = g.in_inf;
+        out_first = g.out_first;
+        out_tar = g.out_tar;
+        out_edge = g.out_edge;
+        out_inf = g.out_inf;
+        einf2 = g.einf2;
+        in_inf2 = g.in_inf2;
+        out_inf2 = g.out_inf2;
+
+        // If g is not sorted, every edge is inside the only SCC, so the
+        // adjacency list of v ends where that of v+1 starts.
+        in_split = ( g.in_split ? g.in_split : g.in_first + 1 );
+        out_split = ( g.out_split ? g.out_split : g.out_first + 1 );
+    }
+
+    // Constructor: view the same SCC as v, with a source node if
+    // add_source is true.
+    ad_scc_view( const ad_scc_view& v, bool add_source )
+    {
+        *this = v;
+        shift = ( add_source ? 1 : 0 );
+        delta = v.delta + v.shift - shift;
+        nnodes = v.nnodes - v.shift + shift;
+    }
+
+    // Get functions for the view:
+    int num_nodes() const
+    {
+        return nnodes;
+    }
+    int num_edges() const
+    {
+        return nedges;
+    }
+
+    // Get functions for the nodes and edges:
+    int degree( int v ) const
+    {
+        return indegree( v ) + outdegree( v );
+    }
+    int indegree( int v ) const
+    {
+        if ( v < shift )
+            return 0;
+        return in_split[ v + delta ] - in_first[ v + delta ];
+    }
+    int outdegree( int v ) const
+    {
+        if ( v < shift )
+            return 0;
+        return out_split[ v + delta ] - out_first[ v + delta ];
+    }
+
+    int source( int e ) const
+    {
+        return esrc[ e + efirst ] - delta;
+    }
+    int target( int e ) const
+    {
+        return etar[ e + efirst ] - delta;
+    }
+    int edge_info( int e ) const
+    {
+        return einf[ e + efirst ];
+    }
+    int edge_info2( int e ) const
+    {
+        return einf2[ e + efirst ];
+    }
+
+    int ith_source_node( int v, int i ) const
+    {
+        return in_src[ in_first[ v + delta ] + i ] - delta;
+    }
+    int ith_source_edge( int v, int i ) const
+    {
+        return in_edge[ in_first[ v + delta ] + i ] - efirst;
+    }
+    int ith_source_edge_info( int v, int i ) const
+    {
+        return in_inf[ in_first[ v + delta ] + i ];
+    }
+    int ith_source_edge_info2( int v, int i ) const
+    {
+        return in_inf2[ in_first[ v + delta ] + i ];
+    }
+
+    int ith_target_node( int v, int i ) const
+    {
+        return out_tar[ out_first[ v + delta ] + i ] - delta;
+    }
+    int ith_target_edge( int v, int i ) const
+    {
+        return out_edge[ out_first[ v + delta ] + i ] - efirst;
+    }
+    int ith_target_edge_info( int v, int i ) const
+    {
+        return out_inf[ out_first[ v + delta ] + i ];
+    }
+    int ith_target_edge_info2( int v, int i ) const
+    {
+        return out_inf2[ out_first[ v + delta ] + i ];
+    }
+
+    // Return the edges as arrays, e.g., for a vectorized scan: source(
+    // e ) is sources()[ e ] - node_offset(), target( e ) is targets()[ e
+    // ] - node_offset(), and edge_info( e ) and edge_info2( e ) are
+    // edge_infos()[ e ] and edge_info2s()[ e ].
+    const int *sources() const
+    {
+        return esrc + efirst;
+    }
+    const int *targets() const
+    {
+        return etar + efirst;
+    }
+    const int *edge_infos() const
+    {
+        return einf + efirst;
+    }
+    const int *edge_info2s() const
+    {
+        return einf2 + efirst;
+    }
+    int node_offset() const
+    {
+        return delta;
+    }
+
+    // Return the node or edge number in the viewed graph.
+    int graph_node( int v ) const
+    {
+        return v + delta;
+    }
+    int graph_edge( int e ) const
+    {
+        return e + efirst;
+    }
+
+    // Regenerate the edge weights of the SCC with a given distribution.
+    void generate_part( ginfo& gi, const args_t& args );
+
+    // I/O functions.
+    void print() const;
+
+private:
+    int nnodes;  // Number of nodes including the source node.
+    int nedges;  // Number of edges.
+    int shift;   // 1 if there is a source node; 0 otherwise.
+    int delta;   // Node v of the view is node v+delta of the graph.
+    int efirst;  // Edge e of the view is edge e+efirst of the graph.
+
+    // The arrays of the viewed graph.
+    int *esrc;
+    int *etar;
+    int *einf;
+    int *in_first;
+    int *in_split;
+    int *in_src;
+    int *in_edge;
+    int *in_inf;
+    int *out_first;
+    int *out_split;
+    int *out_tar;
+    int *out_edge;
+    int *out_inf;
+    int *einf2;
+    int *in_inf2;
+    int *out_inf2;
+};  // ad_scc_view
+
 // Component information. The compiler doesn't inline operator= if I
 // write the constructors in terms of this operator.
 struct cninfo {
@@ -822,7 +737,7 @@ struct cninfo {
     {
         comp = ci.comp;
     }
-    cninfo( ad_graph< ninfo > *g )
+    cninfo( ad_scc_view *g )
     {
         comp = g;
     }
@@ -843,7 +758,7 @@ struct cninfo {
     {
         comp = ci.comp;
     }
-    void operator=( ad_graph< ninfo > *g )
+    void operator=( ad_scc_view *g )
     {
         comp = g;
     }
@@ -855,7 +770,7 @@ struct cninfo {
     }
 
     // Pointer to the SCC.
-    ad_graph< ninfo > *comp;
+    ad_scc_view *comp;
 };
 
 ///////////////////////////////////////////////////////////////////////
@@ -869,11 +784,19 @@ extern
 void 
 clear_components( ad_graph< cninfo >& cg );
 
+// Algorithms to find the SCCs with.
+enum {
+    SCC_TWO_PASS,  // Kosaraju: DFS over the outedges, then the inedges.
+    SCC_ONE_PASS,  // Pearce: one DFS over the outedges.
+    SCC_PARALLEL   // Trimming and forward-backward reach on many threads.
+};
+
 extern 
 bool
 find_components( ad_graph< cninfo >& cg, 
-                 const ad_graph< ninfo >& g, 
-                 bool has_self_loop, bool already_sc = false );
+                 ad_graph< ninfo >& g, 
+                 bool has_self_loop, bool already_sc = false,
+                 int scc_alg = SCC_TWO_PASS, int nthreads = 1 );
 
 extern
 void
@@ -884,48 +807,505 @@ generate_part_for_all_components( ad_graph< cninfo >& cg,
 ///////////////////////////////////////////////////////////////////////
 // Optimum Cycle mean (=ratio) functions:
 
-// Find the min cycle ratio for a SCC g.
-extern
-float
-find_min_cycle_ratio_for_scc( const ad_graph< ninfo > *g, 
-                              int plus_infinity,
-                              float lambda_so_far );
+// The policy and the node potentials with which a solver stopped on an
+// SCC. When the edge weights of the SCC change a little, Howard's and
+// the value iteration algorithms start from these rather than from
+// scratch, and converge in a few iterations. Any other solver ignores
+// them. The weight of each policy edge is kept to detect the policy
+// edges that changed: their nodes start from scratch since their old
+// policy, e.g., the old critical cycle, would mislead the solver.
+struct ad_warm_start {
+
+    // Constructor and destructor:
+    ad_warm_start()
+    {
+        nnodes = 0;
+        policy = NULL;
+        dist = NULL;
+        einfo = NULL;
+        einfo2 = NULL;
+    }
+    ~ad_warm_start()
+    {
+        free();
+    }
+
+    // Return true if there is a policy for a SCC with n nodes.
+    bool is_valid( int n ) const
+    {
+        return ( 0 < nnodes ) && ( n == nnodes );
+    }
+
+    // Make room for the policy of a SCC with n nodes.
+    void alloc( int n )
+    {
+        if ( n != nnodes ) {
+            free();
+            nnodes = n;
+            policy = new int[ n ];
+            dist = new double[ n ];
+            einfo = new int[ n ];
+            einfo2 = new int[ n ];
+        }
+    }
+
+    int    nnodes;
+    int    *policy;  // policy[v] is the outedge of node v in the policy.
+    double *dist;    // dist[v] is the potential of node v in any dist_t.
+    int    *einfo;   // einfo[v] is the weight of policy[v].
+    int    *einfo2;  // einfo2[v] is the transit time of policy[v].
+
+private:
+
+    void free()
+    {
+        delete [] policy;
+        delete [] dist;
+        delete [] einfo;
+        delete [] einfo2;
+    }
+};
+
+// A cycle as its edges in the order of traversal. A solver finds it as
+// a by-product of finding lambda, e.g., the policy cycle of Howard's
+// algorithm or the negative cycle of the last shortest path run, so it
+// costs no extra pass over the graph. Its ratio is exactly
+// total_weight / total_length, once set by set_totals().
+struct ad_cycle {
+
+    // Constructor and destructor:
+    ad_cycle()
+    {
+        len = 0;
+        size = 0;
+        edges = NULL;
+        total_weight = 0;
+        total_length = 0;
+    }
+    ~ad_cycle()
+    {
+        delete [] edges;
+    }
+
+    // Empty the cycle and make room for a cycle with n edges.
+    void reset( int n )
+    {
+        if ( n > size ) {
+            delete [] edges;
+            size = n;
+            edges = new int[ n ];
+        }
+        len = 0;
+        total_weight = 0;
+        total_length = 0;
+    }
+
+    void add( int e )
+    {
+#ifdef DEBUG
+        assert( len < size );
+#endif
+        edges[ len++ ] = e;
+    }
+
+    // Reverse the order of the edges, e.g., after they are added while
+    // going backwards over the cycle.
+    void reverse()
+    {
+        for ( int i = 0, j = len - 1; i < j; ++i, --j ) {
+            int e = edges[ i ];
+            edges[ i ] = edges[ j ];
+            edges[ j ] = e;
+        }
+    }
+
+    void copy( const ad_cycle& c )
+    {
+        reset( c.len );
+        for ( int i = 0; i < c.len; ++i )
+            edges[ i ] = c.edges[ i ];
+        len = c.len;
+        total_weight = c.total_weight;
+        total_length = c.total_length;
+    }
+
+    // Set the totals of the cycle, whose edges are those of g.
+    template< class graph_t >
+    void set_totals( const graph_t *g )
+    {
+        total_weight = 0;
+        total_length = 0;
+        for ( int i = 0; i < len; ++i ) {
+            total_weight += g->edge_info( edges[ i ] );
+            total_length += g->edge_info2( edges[ i ] );
+        }
+    }
+
+    // Return true if the ratio of the cycle is less than w / t, where
+    // t is positive, comparing in 128-bit integers, in which the
+    // products cannot overflow.
+    bool is_below( long long w, long long t ) const
+    {
+        return ( __int128 ) total_weight * t < ( __int128 ) w * total_length;
+    }
+
+    int       len;           // Number of edges.
+    int       size;          // Number of edges there is room for.
+    int       *edges;
+    long long total_weight;  // Total weight of the edges.
+    long long total_length;  // Total transit time.
+
+private:
+
+    // A cycle owns its edges, so it cannot be copied.
+    ad_cycle( const ad_cycle& );
+    void operator=( const ad_cycle& );
+};
+
+// Solver information. When the SCCs are solved by many threads, best
+// is the smallest lambda found so far over all the SCCs; otherwise, it
+// is NULL. When solvers race on the same SCC, stop is set once one of
+// them finishes; otherwise, it is NULL. If warm is not NULL, a solver
+// that can start from a policy starts from warm if it is valid, and
+// saves its final policy into warm. If cycle is not NULL, a solver
+// sets it to a cycle of g whose ratio is the lambda it returns, within
+// EPSILON for the solvers that search for lambda, or empties it if it
+// returns lambda_so_far without finding such a cycle of g. nthreads
+// is the number of threads a solver may use on g, or 0 for its serial
+// version; only Howard's algorithm uses more than one. For any
+// nthreads above 0, it takes the same steps, which differ from those
+// of its serial version. Only the lone SCC to solve gets nthreads above
+// 0; the SCCs solved by many threads or raced get 0.
+struct sinfo {
+
+    // Constructor:
+    sinfo()
+    {
+        best = NULL;
+        stop = NULL;
+        warm = NULL;
+        cycle = NULL;
+        nthreads = 0;
+    }
+
+    // Return the smaller of l and the best lambda. A solver can stop
+    // as soon as its lower bound reaches this value.
+    template< class dist_t >
+    dist_t lambda_so_far( dist_t l ) const
+    {
+        if ( best )
+            min2( l, ( dist_t ) best->get() );
+        return l;
+    }
+
+    // Return true if the solver should give up because another solver
+    // finished first. A solver checks this once per iteration of its
+    // main loop; its result is then ignored.
+    bool stopped() const
+    {
+        return ( stop && stop->is_set() );
+    }
+
+    const ad_shared_lambda *best;
+    const ad_stop_flag     *stop;
+    ad_warm_start          *warm;
+    ad_cycle               *cycle;
+    int                    nthreads;  // Threads the solver may use for the SCC, or 0.
+};
+
+// A numeric policy for a solver: weight_t holds the edge weights and
+// transit times that a solver copies into its node info, total_t holds
+// their sums, e.g., over a cycle or a path, and dist_t holds the node
+// potentials and lambda. plus_infinity, the total edge weight plus 2,
+// must fit in total_t. If unit_ttime is true, every transit time is 1,
+// i.e., the problem is the cycle mean problem, and the solver never
+// reads the transit times (see edge_ttime()).
+template< class weight_t_, class total_t_, class dist_t_, bool unit_ttime_ >
+struct ad_numeric {
+    typedef weight_t_ weight_t;
+    typedef total_t_  total_t;
+    typedef dist_t_   dist_t;
+
+    static const bool unit_ttime = unit_ttime_;
+};
+
+// The policies each solver is instantiated for. The 16-bit one makes
+// the node info of the solvers smaller for SCCs whose weights and
+// transit times fit in 16 bits, and the 64-bit one keeps the sums from
+// overflowing and the potentials precise on graphs whose total edge
+// weight does not fit in 32 bits. The input weights are ints, so the
+// 64-bit policy widens the sums, not the weights.
+typedef ad_numeric< short, int, float, false >       ad_num16;
+typedef ad_numeric< int, int, float, false >         ad_num32;
+typedef ad_numeric< int, long long, double, false >  ad_num64;
+
+// The same policies for the SCCs whose transit times are all 1.
+typedef ad_numeric< short, int, float, true >        ad_mean16;
+typedef ad_numeric< int, int, float, true >          ad_mean32;
+typedef ad_numeric< int, long long, double, true >   ad_mean64;
+
+// The transit time of edge e of g, or of the ith inedge or outedge of
+// node v of g, under the policy num_t: 1 without reading g if
+// num_t::unit_ttime.
+template< class num_t >
+inline
+int
+edge_ttime( const ad_scc_view *g, int e )
+{
+    return ( num_t::unit_ttime ? 1 : g->edge_info2( e ) );
+}
+
+template< class num_t >
+inline
+int
+ith_source_edge_ttime( const ad_scc_view *g, int v, int i )
+{
+    return ( num_t::unit_ttime ? 1 : g->ith_source_edge_info2( v, i ) );
+}
+
+template< class num_t >
+inline
+int
+ith_target_edge_ttime( const ad_scc_view *g, int v, int i )
+{
+    return ( num_t::unit_ttime ? 1 : g->ith_target_edge_info2( v, i ) );
+}
+
+// The transit times of the edges of g as an array (see
+// ad_scc_view::edge_info2s()), or NULL without reading g if
+// num_t::unit_ttime.
+template< class num_t >
+inline
+const int *
+edge_ttimes( const ad_scc_view *g )
+{
+    return ( num_t::unit_ttime ? NULL : g->edge_info2s() );
+}
+
+// The transit time of an edge that a solver keeps in the node info,
+// e.g., of the policy edge of a node. It takes no space, and is always
+// 1, if num_t::unit_ttime: the node info of a solver derives from it.
+template< class num_t, bool unit_ttime = num_t::unit_ttime >
+struct ad_ttime_info {
+    int einfo2() const
+    {
+        return t;
+    }
+    void set_einfo2( int ei2 )
+    {
+        t = ( typename num_t::weight_t ) ei2;
+    }
+
+private:
+    typename num_t::weight_t t;
+};
+
+template< class num_t >
+struct ad_ttime_info< num_t, true > {
+    int einfo2() const
+    {
+        return 1;
+    }
+    void set_einfo2( int )
+    {
+        /* EMPTY */
+    }
+};
+
+// The policies to choose from by bits, e.g., with '-i' (see
+// ad_util.cc). NUM_AUTO takes the narrowest policy that fits each SCC.
+enum {
+    NUM_AUTO = 0,
+    NUM_16 = 16,
+    NUM_32 = 32,
+    NUM_64 = 64
+};
+
+// The function of a solver for the numeric policy num_t.
+template< class num_t >
+struct ad_solver_func {
+    typedef typename num_t::dist_t ( *type )( const ad_scc_view *g, 
+                                              typename num_t::total_t plus_infinity,
+                                              typename num_t::dist_t lambda_so_far,
+                                              const sinfo& si );
+};
+
+// A solver: an algorithm to find the min cycle ratio for a SCC g, once
+// for each numeric policy. Each ad_alg_*.cc file defines one solver as
+// a function template, instantiates it for each policy with
+// AD_SOLVER_FUNCS, and registers it with an ad_solver_registrar, so an
+// executable can choose among the solvers linked into it at runtime.
+struct ad_solver {
+    const char                        *name;
+    bool                              add_source;  // True if g needs a source node.
+    ad_solver_func< ad_num16 >::type  find_min_cycle_ratio_for_scc16;
+    ad_solver_func< ad_num32 >::type  find_min_cycle_ratio_for_scc32;
+    ad_solver_func< ad_num64 >::type  find_min_cycle_ratio_for_scc64;
+    ad_solver_func< ad_mean16 >::type find_min_cycle_mean_for_scc16;
+    ad_solver_func< ad_mean32 >::type find_min_cycle_mean_for_scc32;
+    ad_solver_func< ad_mean64 >::type find_min_cycle_mean_for_scc64;
+};
+
+// The instances of the solver function template f for the members of
+// ad_solver, in order.
+#define AD_SOLVER_FUNCS( f ) \
+    f< ad_num16 >, f< ad_num32 >, f< ad_num64 >, \
+    f< ad_mean16 >, f< ad_mean32 >, f< ad_mean64 >
+
+// Add s to the registry of solvers.
+void
+register_solver( const ad_solver *s );
+
+// Return the solver with the given name, or NULL if there is none. If
+// name is NULL or empty, return the default solver: the only solver if
+// one is registered, or Howard's otherwise.
+const ad_solver *
+find_solver( const char *name );
+
+// Return the number of registered solvers and the ith one.
+int
+num_solvers();
+const ad_solver *
+ith_solver( int i );
+
+struct ad_solver_registrar {
+    ad_solver_registrar( const ad_solver *s )
+    {
+        register_solver( s );
+    }
+};
+
+// The solvers defined in the ad_alg_*.cc files. Naming them pulls their
+// files out of a library such as libocr.a.
+extern const ad_solver burns_solver;
+extern const ad_solver howard_solver;
+extern const ad_solver ko_solver;
+extern const ad_solver lawler_solver;
+extern const ad_solver szymanski_solver;
+extern const ad_solver tarjan_solver;
+extern const ad_solver valiter_solver;
+extern const ad_solver yto_solver;
+
+// The state kept between the solves of the component graph cg so that,
+// after the weights of a few edges change, only the SCCs with those
+// edges are solved again, each from the policy its solver stopped
+// with. The edges are numbered as in the graph of cg. Initially, every
+// SCC is to be solved.
+class ad_resolve_state {
+public:
+
+    // Constructor and destructor: m is the number of edges of the graph
+    // of cg.
+    ad_resolve_state( const ad_graph< cninfo >& cg, int m );
+    ~ad_resolve_state();
+
+    // Mark the SCC with edge e, if any, to be solved again.
+    void mark_edge( int e )
+    {
+        if ( -1 != scc_of_edge[ e ] )
+            changed[ scc_of_edge[ e ] ] = true;
+    }
+
+    // Mark every SCC to be solved again, and from scratch if cold is
+    // true, e.g., after every weight is negated.
+    void mark_all( bool cold );
+
+    int           nsccs;
+    int           *scc_of_edge;  // The SCC with edge e, or -1.
+    bool          *changed;      // True if SCC v is to be solved again.
+    double        *scc_lambda;   // The lambda of SCC v when last solved.
+    ad_warm_start *warm;         // The policy of SCC v when last solved.
+    ad_cycle      *cycles;       // The critical cycle of SCC v when last solved.
+
+private:
+
+    // A state cannot be copied.
+    ad_resolve_state( const ad_resolve_state& );
+    void operator=( const ad_resolve_state& );
+};
 
 // Find the min cycle mean of the component graph cg by going over its
-// SCCs using the previous function.
+// SCCs using solvers[0]. If nsolvers is more than one, the solvers race
+// on each large SCC: each runs on its own thread, the first to finish
+// gives the lambda, and the others are stopped. If nthreads is more
+// than one, the SCCs are solved by that many threads in the order of
+// decreasing size, or if there is only one SCC to solve, its solver
+// gets the threads (see sinfo::nthreads). If nthreads is 0 or 1, the
+// SCCs are solved in turn, and with 1, the lone SCC to solve gets the
+// parallel version of Howard's algorithm on one thread. If rs is not
+// NULL, only the SCCs marked in rs are solved, without the lambdas of
+// the other SCCs as bounds, and rs is updated. If cycle is not NULL, it is set to a critical cycle as
+// edges of the graph of cg, which g.orig_edge() maps to the input
+// edges, or emptied if the solver found none (see sinfo). Each SCC is
+// solved with the numeric policy given by num_bits (see NUM_AUTO), or
+// a wider one if its weights or plus_infinity need it, and with the
+// cycle mean instance of the policy if its transit times are all 1.
 extern
-float 
+double
 find_min_cycle_ratio_for_components( const ad_graph< cninfo >& cg, 
-                                     int plus_infinity );
+                                     long long plus_infinity,
+                                     const ad_solver **solvers,
+                                     int nsolvers = 1,
+                                     int nthreads = 0,
+                                     ad_resolve_state *rs = NULL,
+                                     ad_cycle *cycle = NULL,
+                                     int num_bits = NUM_AUTO );
 
 inline
-float 
+double
 find_max_cycle_ratio_for_components( const ad_graph< cninfo >& cg,
-                                     int plus_infinity )
+                                     long long plus_infinity,
+                                     const ad_solver **solvers,
+                                     int nsolvers = 1,
+                                     int nthreads = 0,
+                                     ad_resolve_state *rs = NULL,
+                                     ad_cycle *cycle = NULL,
+                                     int num_bits = NUM_AUTO )
 {
     // Assuming that the edge weights are negated in the input graph.
-    return -find_min_cycle_ratio_for_components( cg, plus_infinity );
+    return -find_min_cycle_ratio_for_components( cg, plus_infinity, solvers, 
+                                                 nsolvers, nthreads, rs, cycle,
+                                                 num_bits );
 }
 
-float 
-find_lambda_bound( const ad_graph< ninfo > *g, 
-                   int plus_infinity, 
-                   bool which );
-
+// Make cycle, e.g., as found by find_min_cycle_ratio_for_components,
+// a min ratio cycle of the SCCs of cg for certain: while an SCC has a
+// cycle with a smaller ratio, found by Bellman-Ford's algorithm with
+// its dists in 128-bit integers, that cycle replaces it. The min cycle
+// ratio is then exactly cycle.total_weight / cycle.total_length,
+// without EPSILON. Return the number of Bellman-Ford runs, one per
+// nontrivial SCC plus one per replacement.
+extern
+int
+verify_min_cycle_ratio_for_components( const ad_graph< cninfo >& cg,
+                                       long long plus_infinity,
+                                       ad_cycle& cycle );
+
+// Instantiated in ad_alg_util.cc for each numeric policy.
+template< class num_t >
+typename num_t::dist_t
+find_lambda_bound( const ad_scc_view *g, 
+                   typename num_t::total_t plus_infinity, 
+                   bool which,
+                   ad_cycle *cycle = NULL );
+
+template< class num_t >
 inline
-float
-find_min_lambda( const ad_graph< ninfo > *g, 
-                 int plus_infinity )
+typename num_t::dist_t
+find_min_lambda( const ad_scc_view *g, 
+                 typename num_t::total_t plus_infinity,
+                 ad_cycle *cycle = NULL )
 {
-    return find_lambda_bound( g, plus_infinity, true );
+    return find_lambda_bound< num_t >( g, plus_infinity, true, cycle );
 }
 
+template< class num_t >
 inline
-float
-find_max_lambda( const ad_graph< ninfo > *g, 
-                 int plus_infinity )
+typename num_t::dist_t
+find_max_lambda( const ad_scc_view *g, 
+                 typename num_t::total_t plus_infinity )
 {
-    return find_lambda_bound( g, plus_infinity, false );
+    return find_lambda_bound< num_t >( g, plus_infinity, false );
 }
 
 #endif
@@ -8,7 +8,76 @@
 #include "ad_graph.h"
 #include "ad_util.h"
 
-int ( *dist_func )( int, int );
+// Print the names of the registered solvers.
+static
+void
+print_solvers()
+{
+    printf( "Available algorithms:" );
+    for ( int i = 0; i < num_solvers(); ++i )
+        printf( " %s", ith_solver( i )->name );
+    printf( "\n" );
+}  // print_solvers
+
+// Find the solvers named in the comma-separated list names into
+// solvers, or the default solver if names is empty. Return the number
+// of solvers found.
+static
+int
+find_solvers( const char *names, const ad_solver **solvers )
+{
+    char buf[ MAX_STR_SIZE ];
+    strcpy( buf, names );
+
+    int n = 0;
+    if ( '\0' == buf[ 0 ] ) {
+        solvers[ n++ ] = find_solver( NULL );
+    } else {
+        for ( char *name = strtok( buf, "," ); name; name = strtok( NULL, "," ) )
+            solvers[ n++ ] = find_solver( name );
+    }
+
+    for ( int i = 0; i < n; ++i ) {
+        if ( NULL == solvers[ i ] ) {
+            printf( "ERROR: Unknown algorithm in '%s'.\n", names );
+            print_solvers();
+            exit( 1 );
+        }
+    }
+
+    return n;
+}  // find_solvers
+
+// Make cycle a min ratio cycle of cg for certain (see
+// verify_min_cycle_ratio_for_components), and return its ratio.
+static
+double
+verify_cycle( const ad_graph< cninfo >& cg, long long plus_infinity, ad_cycle& cycle )
+{
+    float total_time = used_time();
+    int nruns = verify_min_cycle_ratio_for_components( cg, plus_infinity, cycle );
+    total_time = used_time() - total_time;
+    printf( "time to verify= %10.2f nruns= %d\n", total_time, nruns );
+
+    return ( double ) cycle.total_weight / cycle.total_length;
+}  // verify_cycle
+
+// Print the exact ratio of the critical cycle. For the max version,
+// the weights are negated, so is the ratio.
+static
+void
+print_cycle_ratio( const ad_cycle& cycle, bool min_version )
+{
+    if ( 0 == cycle.len )
+        return;
+
+    if ( min_version )
+        printf( "final min_ratio= %lld / %lld len= %d\n", 
+                cycle.total_weight, cycle.total_length, cycle.len );
+    else
+        printf( "final max_ratio= %lld / %lld len= %d\n", 
+                -cycle.total_weight, cycle.total_length, cycle.len );
+}  // print_cycle_ratio
 
 int
 main( int argc, char *argv[] )
@@ -20,6 +89,16 @@ main( int argc, char *argv[] )
 
     parse_args( argc, argv, args );
 
+    // The solvers to run, one after another on the same components, or
+    // all at once if they race. Howard's, YTO, and Tarjan's algorithms
+    // race by default as each of them wins on some graphs.
+    if ( args.race && ( '\0' == args.alg_names[ 0 ] ) )
+        strcpy( args.alg_names, "howard,yto,tarjan" );
+    const ad_solver *solvers[ MAX_STR_SIZE ];
+    int             nsolvers = find_solvers( args.alg_names, solvers );
+    int             nsolves = ( args.race ? 1 : nsolvers );  // Solves per run.
+    int             nracers = ( args.race ? nsolvers : 1 );  // Solvers per solve.
+
     float total_time;
 
     // Read or generate input graph.
@@ -41,9 +120,11 @@ main( int argc, char *argv[] )
         case 1:
             {
                 total_time = used_time();
-                g.read( gi, args );
+                if ( !g.read( gi, args ) )
+                    exit( 1 );
                 total_time = used_time() - total_time;
                 printf( "time to read input graph= %10.2f\n", total_time );
+                g.fprint( args );
             }
             break;
         case 2:
@@ -74,7 +155,8 @@ main( int argc, char *argv[] )
     {
         total_time = used_time();
         if ( 2 != args.mode )
-            is_acyclic = find_components( cg, g, gi.has_self_loop );
+            is_acyclic = find_components( cg, g, gi.has_self_loop, false, 
+                                          args.scc_alg, max( 1, args.nthreads ) );
         else
             is_acyclic = find_components( cg, g, gi.has_self_loop, true );
         total_time = used_time() - total_time;
@@ -99,7 +181,8 @@ main( int argc, char *argv[] )
 
         // If g is cyclic, we have to compute its optimum cycle mean via cg.
 
-        float lambda;
+        double   lambda;
+        ad_cycle cycle;
 
         if ( args.min_version ) {
             for ( int run_no = 0; run_no < args.nruns; ++run_no ) {
@@ -111,16 +194,26 @@ main( int argc, char *argv[] )
                     generate_part_for_all_components( cg, gi, args );
                 }
 
+                for ( int k = 0; k < nsolves; ++k ) {
+                    if ( 1 < nsolves )
+                        printf( "algorithm= %s\n", solvers[ k ]->name );
 #ifdef REP_COUNT
-                begin_count();
+                    begin_count();
 #endif
-                total_time = used_time();
-                lambda = find_min_cycle_ratio_for_components( cg, gi.total_edge_weight );
-                total_time = used_time() - total_time;
+                    total_time = used_time();
+                    lambda = find_min_cycle_ratio_for_components( cg, gi.total_edge_weight, 
+                                                                  &solvers[ k ], nracers,
+                                                                  args.nthreads, NULL, &cycle,
+                                                                  args.num_bits );
+                    total_time = used_time() - total_time;
 #ifdef REP_COUNT
-                print_count();
+                    print_count();
 #endif
-                printf( "final min_lambda= %10.2f time= %10.2f\n", lambda, total_time );
+                    if ( args.exact )
+                        lambda = verify_cycle( cg, gi.total_edge_weight, cycle );
+                    printf( "final min_lambda= %10.2f time= %10.2f\n", lambda, total_time );
+                    print_cycle_ratio( cycle, true );
+                }
             }
         } else {
             for ( int run_no = 0; run_no < args.nruns; ++run_no ) {
@@ -132,16 +225,26 @@ main( int argc, char *argv[] )
                     generate_part_for_all_components( cg, gi, args );
                 }
 
+                for ( int k = 0; k < nsolves; ++k ) {
+                    if ( 1 < nsolves )
+                        printf( "algorithm= %s\n", solvers[ k ]->name );
 #ifdef REP_COUNT
-                begin_count();
+                    begin_count();
 #endif
-                total_time = used_time();
-                lambda = find_max_cycle_ratio_for_components( cg, gi.total_edge_weight );
-                total_time = used_time() - total_time;
+                    total_time = used_time();
+                    lambda = find_max_cycle_ratio_for_components( cg, gi.total_edge_weight, 
+                                                                  &solvers[ k ], nracers,
+                                                                  args.nthreads, NULL, &cycle,
+                                                                  args.num_bits );
+                    total_time = used_time() - total_time;
 #ifdef REP_COUNT
-                print_count();
+                    print_count();
 #endif
-                printf( "final max_lambda= %10.2f time= %10.2f\n", lambda, total_time );
+                    if ( args.exact )
+                        lambda = -verify_cycle( cg, gi.total_edge_weight, cycle );
+                    printf( "final max_lambda= %10.2f time= %10.2f\n", lambda, total_time );
+                    print_cycle_ratio( cycle, false );
+                }
             }
         }
 
@@ -0,0 +1,163 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+// The library interface: see ad_ocr.h.
+
+#include "ad_graph.h"
+#include "ad_util.h"
+#include "ad_ocr.h"
+
+// The solvers of the library. Naming them here links them into every
+// program that calls ocr_solve.
+static const ad_solver *ocr_solvers[] = {
+    &burns_solver,
+    &howard_solver,
+    &ko_solver,
+    &lawler_solver,
+    &szymanski_solver,
+    &tarjan_solver,
+    &valiter_solver,
+    &yto_solver
+};
+
+const int NUM_OCR_SOLVERS = sizeof( ocr_solvers ) / sizeof( ocr_solvers[ 0 ] );
+
+// Return the solver whose name is the len characters at name, or NULL
+// if there is none.
+static
+const ad_solver *
+find_ocr_solver( const char *name, int len )
+{
+    for ( int i = 0; i < NUM_OCR_SOLVERS; ++i ) {
+        const char *s = ocr_solvers[ i ]->name;
+        if ( ( ( int ) strlen( s ) == len ) && !strncmp( s, name, len ) )
+            return ocr_solvers[ i ];
+    }
+    return NULL;
+}  // find_ocr_solver
+
+// Find the solvers named in the comma-separated list names into
+// solvers, or only the first name unless race is true. Return the
+// number of solvers found, or 0 if a name is unknown.
+static
+int
+find_ocr_solvers( const char *names, bool race, const ad_solver **solvers )
+{
+    // Howard's, YTO, and Tarjan's algorithms race by default as in
+    // ad_main.cc.
+    if ( NULL == names )
+        names = ( race ? "howard,yto,tarjan" : "howard" );
+
+    int n = 0;
+    while ( n < NUM_OCR_SOLVERS ) {
+        const char *end = strchr( names, ',' );
+        int len = ( end ? end - names : strlen( names ) );
+
+        solvers[ n ] = find_ocr_solver( names, len );
+        if ( NULL == solvers[ n++ ] )
+            return 0;
+
+        if ( ( NULL == end ) || !race )
+            break;
+        names = end + 1;
+    }
+
+    return n;
+}  // find_ocr_solvers
+
+int
+ocr_solve( const ocr_graph& og, const ocr_options& opts, ocr_result& res )
+{
+    delete [] res.cycle;
+    res.cycle = NULL;
+    res.cycle_len = 0;
+    res.cycle_weight = res.cycle_ttime = 0;
+    res.lambda = 0.0;
+    res.acyclic = false;
+    res.build_time = res.scc_time = res.solve_time = res.verify_time = res.cycle_time = 0.0;
+
+    const ad_solver *solvers[ NUM_OCR_SOLVERS ];
+    int             nsolvers = find_ocr_solvers( opts.algorithms, opts.race, solvers );
+    if ( 0 == nsolvers )
+        return res.status = OCR_BAD_ALGORITHM;
+
+    if ( ( og.n <= 0 ) || ( og.m < 0 ) )
+        return res.status = OCR_BAD_GRAPH;
+
+    // The arguments that build() uses: the weights are taken as is,
+    // and negated for the max version.
+    args_t args;
+    args.mode = 0;
+    args.min_version = opts.min_version;
+    args.offset = 0;
+
+    int nthreads = max( 0, opts.nthreads );
+
+    // Copy the graph.
+    ad_graph< ninfo > g;
+    ginfo             gi;
+
+    float t = used_time();
+    bool ok = g.build( gi, args, og.n, og.m, og.src, og.tar, og.weight, og.ttime );
+    res.build_time = used_time() - t;
+    if ( ! ok )
+        return res.status = OCR_BAD_GRAPH;
+
+    // Find the SCCs. If g is acyclic, there is nothing else to do.
+    ad_graph< cninfo > cg;
+
+    t = used_time();
+    res.acyclic = find_components( cg, g, gi.has_self_loop, false,
+                                   opts.scc_alg, max( 1, nthreads ) );
+    res.scc_time = used_time() - t;
+    if ( res.acyclic )
+        return res.status = OCR_OK;
+
+    // Find lambda. The weights of g are negated for the max version,
+    // so min_lambda is for g as it is.
+#ifdef REP_COUNT
+    begin_count();
+#endif
+    ad_cycle cycle;
+
+    t = used_time();
+    double min_lambda = find_min_cycle_ratio_for_components( cg, gi.total_edge_weight,
+                                                             solvers, nsolvers, nthreads,
+                                                             NULL, &cycle, opts.num_bits );
+    res.solve_time = used_time() - t;
+#ifdef REP_COUNT
+    end_count();
+#endif
+
+    // Make the critical cycle optimum for certain, and take its ratio.
+    // If the solver found no cycle, which none of them should do, this
+    // also finds one, so the cycle is never one that -x 1 would reject.
+    if ( opts.exact || ( 0 == cycle.len ) ) {
+        t = used_time();
+        verify_min_cycle_ratio_for_components( cg, gi.total_edge_weight, cycle );
+        res.verify_time = used_time() - t;
+        min_lambda = ( double ) cycle.total_weight / cycle.total_length;
+    }
+    res.lambda = ( opts.min_version ? min_lambda : -min_lambda );
+
+    // Take the critical cycle.
+    t = used_time();
+    res.cycle = new int[ cycle.len ];
+    res.cycle_len = cycle.len;
+    for ( int i = 0; i < cycle.len; ++i )
+        res.cycle[ i ] = g.orig_edge( cycle.edges[ i ] );
+
+    // Sum the cycle edges as given, i.e., not negated for the max version.
+    for ( int i = 0; i < res.cycle_len; ++i ) {
+        int e = res.cycle[ i ];
+        res.cycle_weight += og.weight[ e ];
+        res.cycle_ttime += ( og.ttime ? og.ttime[ e ] : 1 );
+    }
+    res.cycle_time = used_time() - t;
+
+    clear_components( cg );
+
+    return res.status = OCR_OK;
+}  // ocr_solve
+
+// End of file
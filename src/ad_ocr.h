@@ -0,0 +1,137 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+#ifndef AD_OCR_INCLUDED
+#define AD_OCR_INCLUDED
+
+#include <stddef.h>  // For NULL.
+
+// The library interface (libocr.a, see 'make libocr'): find the
+// optimum cycle ratio of a graph given in arrays, without ad_main.cc.
+// Nothing is printed unless the library is built with one of the
+// printing flags, e.g., -DPRINT_SCC.
+//
+// Example:
+//
+//     ocr_graph   g( n, m, src, tar, weight, ttime );
+//     ocr_options opts;
+//     ocr_result  res;
+//     if ( OCR_OK == ocr_solve( g, opts, res ) && !res.acyclic )
+//         ... use res.lambda and res.cycle[ 0 .. res.cycle_len-1 ] ...
+
+// Return codes of ocr_solve.
+enum {
+    OCR_OK,             // Solved.
+    OCR_BAD_GRAPH,      // A node or weight is out of range, or n or m is negative.
+    OCR_BAD_ALGORITHM   // An unknown algorithm name.
+};
+
+// A graph with nodes 0, ..., n-1 and edges 0, ..., m-1: edge e is
+// src[e] -> tar[e] with weight weight[e] and transit time ttime[e]. If
+// ttime is NULL, every transit time is 1, i.e., the ratio is the mean.
+// The arrays are copied, so they can be freed after ocr_solve.
+struct ocr_graph {
+
+    // Constructor:
+    ocr_graph( int n_, int m_, const int *src_, const int *tar_,
+               const int *weight_, const int *ttime_ = NULL )
+    {
+        n = n_;
+        m = m_;
+        src = src_;
+        tar = tar_;
+        weight = weight_;
+        ttime = ttime_;
+    }
+
+    int       n;
+    int       m;
+    const int *src;
+    const int *tar;
+    const int *weight;
+    const int *ttime;
+};
+
+// Options for ocr_solve.
+struct ocr_options {
+
+    // Constructor: the min cycle ratio by Howard's algorithm on one
+    // thread.
+    ocr_options()
+    {
+        min_version = true;
+        algorithms = NULL;
+        race = false;
+        nthreads = 0;
+        scc_alg = 0;
+        exact = false;
+        num_bits = 0;
+    }
+
+    bool       min_version;  // Min or max cycle ratio.
+    const char *algorithms;  // Algorithm name, e.g., "yto", or NULL for Howard's.
+    bool       race;         // If true, algorithms is a comma-separated
+                             // list of algorithms to race on each SCC.
+    int        nthreads;     // Number of threads to find and solve the SCCs with,
+                             // or 0 for one thread. Any number above 0 gives
+                             // the same result, which may differ from that of 0.
+    int        scc_alg;      // SCC algorithm: 0=two-pass, 1=one-pass, 2=parallel.
+    bool       exact;        // If true, the critical cycle is verified to be
+                             // optimum in integers, and lambda is its ratio.
+    int        num_bits;     // Bits of the solver numbers: 16, 32, 64, or 0 for
+                             // the narrowest that fits each SCC.
+};
+
+// The result of ocr_solve. The times are in seconds as measured by
+// used_time() in ad_util.cc.
+struct ocr_result {
+
+    // Constructor and destructor:
+    ocr_result()
+    {
+        status = OCR_OK;
+        lambda = 0.0;
+        acyclic = false;
+        cycle = NULL;
+        cycle_len = 0;
+        cycle_weight = cycle_ttime = 0;
+        build_time = scc_time = solve_time = verify_time = cycle_time = 0.0;
+    }
+    ~ocr_result()
+    {
+        delete [] cycle;
+    }
+
+    int   status;      // The return code of ocr_solve.
+    double lambda;     // The optimum cycle ratio unless acyclic.
+    bool  acyclic;     // True if the graph has no cycles.
+
+    // A critical cycle as edge numbers of the input graph in the order
+    // of traversal, i.e., a cycle whose ratio is lambda within EPSILON,
+    // or exactly if exact is set in the options or the solver found no
+    // cycle. Its ratio is exactly cycle_weight / cycle_ttime.
+    int       *cycle;
+    int       cycle_len;
+    long long cycle_weight;  // Total weight of the cycle edges.
+    long long cycle_ttime;   // Total transit time of the cycle edges.
+
+    float build_time;  // Time to copy the graph.
+    float scc_time;    // Time to find the SCCs.
+    float solve_time;  // Time to find lambda.
+    float verify_time; // Time to verify the critical cycle, if exact or
+                       // the solver found none.
+    float cycle_time;  // Time to map the critical cycle that the
+                       // solver found to the input edges.
+
+private:
+
+    // A result owns its cycle, so it cannot be copied.
+    ocr_result( const ocr_result& );
+    void operator=( const ocr_result& );
+};
+
+// Find the optimum cycle ratio of g into res and return res.status.
+int
+ocr_solve( const ocr_graph& g, const ocr_options& opts, ocr_result& res );
+
+#endif
@@ -0,0 +1,83 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+// A test of the library interface (see ad_ocr.h) on the graph in
+// ../input/sample.d, built in memory. Usage:
+//
+//     libtest.x [-v/ersion 0/1] [-a/lg name] [-x/act 0/1]
+//
+// The output has the lambda and the ratio of the critical cycle in the
+// format of the executables so that utest.sh can check them.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ad_ocr.h"
+
+// The graph in ../input/sample.d with its nodes numbered from 0.
+const int N = 4;
+const int M = 7;
+const int SRC[ M ]    = {  0,  1,  1,  2,  3,  1,  3 };
+const int TAR[ M ]    = {  1,  0,  2,  0,  2,  3,  0 };
+const int WEIGHT[ M ] = { 40, 60, 50, 30, 60, 70, 30 };
+const int TTIME[ M ]  = {  9, 17,  8, 24, 22, 14, 20 };
+
+int
+main( int argc, char *argv[] )
+{
+    ocr_options opts;
+
+    for ( int i = 1; i + 1 < argc; i += 2 ) {
+        if ( !strncmp( argv[ i ], "-v", 2 ) ) {
+            opts.min_version = ( 0 != atoi( argv[ i + 1 ] ) );
+        } else if ( !strncmp( argv[ i ], "-a", 2 ) ) {
+            opts.algorithms = argv[ i + 1 ];
+        } else if ( !strncmp( argv[ i ], "-x", 2 ) ) {
+            opts.exact = ( 0 != atoi( argv[ i + 1 ] ) );
+        } else {
+            printf( "Usage: %s [-v/ersion 0/1] [-a/lg name] [-x/act 0/1]\n", argv[ 0 ] );
+            exit( 1 );
+        }
+    }
+
+    ocr_graph  g( N, M, SRC, TAR, WEIGHT, TTIME );
+    ocr_result res;
+
+    if ( OCR_OK != ocr_solve( g, opts, res ) ) {
+        printf( "ERROR: ocr_solve returned %d.\n", res.status );
+        exit( 1 );
+    }
+
+    const char *which = ( opts.min_version ? "min" : "max" );
+    printf( "final %s_lambda= %10.2f time= %10.2f\n", which, res.lambda, res.solve_time );
+
+    // The critical cycle must be a cycle of the graph, its ratio must
+    // be lambda, and its totals must be as returned.
+    bool valid = ( 0 < res.cycle_len );
+    int  total_weight = 0;
+    int  total_ttime = 0;
+    for ( int i = 0; valid && ( i < res.cycle_len ); ++i ) {
+        int e = res.cycle[ i ];
+        int f = res.cycle[ ( i + 1 ) % res.cycle_len ];
+        if ( ( e < 0 ) || ( M <= e ) || ( f < 0 ) || ( M <= f ) || ( TAR[ e ] != SRC[ f ] ) )
+            valid = false;
+        else {
+            total_weight += WEIGHT[ e ];
+            total_ttime += TTIME[ e ];
+        }
+    }
+
+    if ( ( total_weight != res.cycle_weight ) || ( total_ttime != res.cycle_ttime ) )
+        valid = false;
+
+    if ( valid )
+        printf( "final cycle_lambda= %10.2f len= %d\n",
+                ( float ) total_weight / total_ttime, res.cycle_len );
+    else
+        printf( "final cycle_lambda= invalid\n" );
+
+    return 0;
+}  // main
+
+// End of file
@@ -0,0 +1,456 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+// A server that keeps graphs and their SCCs in memory and solves them
+// on request, so that a query needs neither a new process nor reading
+// the graph nor finding its SCCs. Usage:
+//
+//     ocrd.x socket_file [-t/hreads nthreads]   start the server
+//     ocrd.x -c socket_file                     send stdin as requests
+//
+// The requests and replies are lines of text over a Unix domain
+// socket. Every request gets one reply line, which starts with "error"
+// if the request failed. The requests are:
+//
+//     load NAME FILE            read FILE as read by the executables
+//                               and find its SCCs; reply "ok n= N m= M"
+//     update NAME E W [T]       set the weight of edge E (edges are
+//                               numbered from 1 in file order) to W,
+//                               which must not be INT_MIN, and its
+//                               transit time to T, which must be
+//                               positive; reply "ok"
+//     solve NAME min|max [ALGS] find lambda as the executables print it
+//                               using ALGS, a comma-separated list of
+//                               algorithms that race if more than one;
+//                               only the SCCs with edges updated since
+//                               the last min (or max) solve are solved,
+//                               by Howard's and the value iteration
+//                               algorithms from their last policy; the
+//                               reply ends with "ratio= W / T cycle=
+//                               E ...", the exact ratio and the edges
+//                               of a critical cycle in order
+//     unload NAME               free the graph; reply "ok"
+//     list                      reply "ok NAME ..."
+//     quit                      close the connection
+//     shutdown                  close the connection and stop the server
+//
+// The requests are served one at a time, and each solve uses up to
+// nthreads threads, or one if -t is not given (see sinfo::nthreads).
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ad_graph.h"
+#include "ad_util.h"
+
+const int MAX_GRAPHS = 64;
+
+// A graph in memory. The weights are kept negated while solve is for
+// the max version, as the executables do.
+struct ocrd_graph {
+    char               name[ MAX_STR_SIZE ];
+    ad_graph< ninfo >  g;
+    ad_graph< cninfo > cg;
+    ginfo              gi;
+    bool               is_acyclic;
+    bool               negated;     // True if the weights are negated.
+    bool               adj_synced;  // False if the adjacency info is stale.
+    int                *new_edge;   // new_edge[e] is the number in g of the eth edge in the file.
+    ad_resolve_state   *rs[ 2 ];    // The state of the max and min solves.
+};
+
+static ocrd_graph *graphs[ MAX_GRAPHS ];
+static int        nthreads = 0;
+
+// Return the index of the graph with the given name, or -1.
+static
+int
+find_graph( const char *name )
+{
+    for ( int i = 0; i < MAX_GRAPHS; ++i ) {
+        if ( graphs[ i ] && !strcmp( graphs[ i ]->name, name ) )
+            return i;
+    }
+    return -1;
+}  // find_graph
+
+static
+void
+free_graph( int i )
+{
+    if ( !graphs[ i ]->is_acyclic ) {
+        delete graphs[ i ]->rs[ 0 ];
+        delete graphs[ i ]->rs[ 1 ];
+        clear_components( graphs[ i ]->cg );
+    }
+    delete [] graphs[ i ]->new_edge;
+    delete graphs[ i ];
+    graphs[ i ] = NULL;
+}  // free_graph
+
+// Set val to the number in s. Return false if s is not an integer or
+// does not fit in an int.
+static
+bool
+parse_int_arg( const char *s, int& val )
+{
+    char *end;
+    errno = 0;
+    long x = strtol( s, &end, 10 );
+    if ( ( end == s ) || ( '\0' != *end ) || errno || ( x < INT_MIN ) || ( INT_MAX < x ) )
+        return false;
+    val = ( int ) x;
+    return true;
+}  // parse_int_arg
+
+// Negate the weights of gr.
+static
+void
+negate_weights( ocrd_graph *gr )
+{
+    for ( int e = 0; e < gr->g.num_edges(); ++e )
+        gr->g.edge_info( e, -gr->g.edge_info( e ) );
+    gr->negated = !gr->negated;
+    gr->adj_synced = false;
+}  // negate_weights
+
+static
+void
+do_load( FILE *out, const char *name, const char *file_name )
+{
+    if ( 0 <= find_graph( name ) ) {
+        fprintf( out, "error graph %s is already loaded\n", name );
+        return;
+    }
+    int i;
+    for ( i = 0; ( i < MAX_GRAPHS ) && graphs[ i ]; ++i )
+        ;
+    if ( MAX_GRAPHS == i ) {
+        fprintf( out, "error too many graphs\n" );
+        return;
+    }
+
+    args_t args;
+    args.mode = 0;
+    strcpy( args.input_file, file_name );
+    args.min_version = true;
+    args.offset = 0;
+    args.nthreads = nthreads;
+
+    ocrd_graph *gr = new ocrd_graph;
+    strcpy( gr->name, name );
+    if ( !gr->g.read( gr->gi, args ) ) {
+        delete gr;
+        fprintf( out, "error cannot load %s\n", file_name );
+        return;
+    }
+    gr->is_acyclic = find_components( gr->cg, gr->g, gr->gi.has_self_loop, false,
+                                      SCC_TWO_PASS, max( 1, nthreads ) );
+    gr->negated = false;
+    gr->adj_synced = true;
+    if ( !gr->is_acyclic ) {
+        gr->rs[ 0 ] = new ad_resolve_state( gr->cg, gr->g.num_edges() );
+        gr->rs[ 1 ] = new ad_resolve_state( gr->cg, gr->g.num_edges() );
+    }
+
+    // Finding the SCCs renumbers the edges.
+    int m = gr->g.num_edges();
+    gr->new_edge = new int[ m ];
+    for ( int e = 0; e < m; ++e )
+        gr->new_edge[ gr->g.orig_edge( e ) ] = e;
+
+    graphs[ i ] = gr;
+
+    fprintf( out, "ok n= %d m= %d\n", gr->g.num_nodes(), m );
+}  // do_load
+
+static
+void
+do_update( FILE *out, ocrd_graph *gr, int e, int w, bool has_t, int t )
+{
+    if ( ( e < 1 ) || ( gr->g.num_edges() < e ) ) {
+        fprintf( out, "error no edge %d\n", e );
+        return;
+    }
+    if ( !is_weight_valid( w ) ) {
+        fprintf( out, "error weight %d is out of range\n", w );
+        return;
+    }
+    if ( has_t && ( t < 1 ) ) {
+        fprintf( out, "error transit time %d is not positive\n", t );
+        return;
+    }
+    e = gr->new_edge[ e - 1 ];
+
+    if ( gr->negated )
+        w = -w;
+    gr->gi.total_edge_weight += abs_val( w ) - abs_val( gr->g.edge_info( e ) );
+    gr->g.edge_info( e, w );
+    if ( has_t ) {
+        gr->gi.total_trans_time += t - gr->g.edge_info2( e );
+        gr->g.edge_info2( e, t );
+    }
+    gr->adj_synced = false;
+
+    if ( !gr->is_acyclic ) {
+        gr->rs[ 0 ]->mark_edge( e );
+        gr->rs[ 1 ]->mark_edge( e );
+    }
+
+    fprintf( out, "ok\n" );
+}  // do_update
+
+static
+void
+do_solve( FILE *out, ocrd_graph *gr, bool min_version, char *alg_names )
+{
+    const ad_solver *solvers[ MAX_STR_SIZE ];
+    int             nsolvers = 0;
+
+    if ( NULL == alg_names ) {
+        solvers[ nsolvers++ ] = find_solver( NULL );
+    } else {
+        char *last;
+        for ( char *name = strtok_r( alg_names, ",", &last ); name;
+              name = strtok_r( NULL, ",", &last ) ) {
+            if ( ( MAX_STR_SIZE == nsolvers ) ||
+                 ( NULL == ( solvers[ nsolvers++ ] = find_solver( name ) ) ) ) {
+                fprintf( out, "error unknown algorithm %s\n", name );
+                return;
+            }
+        }
+    }
+
+    if ( gr->is_acyclic ) {
+        if ( min_version )
+            fprintf( out, "final min_lambda= infinity time= 0.00\n" );
+        else
+            fprintf( out, "final max_lambda= -infinity time= 0.00\n" );
+        return;
+    }
+
+    if ( gr->negated == min_version )
+        negate_weights( gr );
+    if ( !gr->adj_synced ) {
+        gr->g.sync_adj_info();
+        gr->adj_synced = true;
+    }
+
+#ifdef REP_COUNT
+    begin_count();
+#endif
+    ad_cycle cycle;
+    float total_time = used_time();
+    double lambda = find_min_cycle_ratio_for_components( gr->cg, gr->gi.total_edge_weight,
+                                                         solvers, nsolvers, nthreads,
+                                                         gr->rs[ min_version ], &cycle );
+    total_time = used_time() - total_time;
+#ifdef REP_COUNT
+    end_count();
+#endif
+
+    // The weights are negated for the max version, so are the ratios.
+    if ( min_version )
+        fprintf( out, "final min_lambda= %10.2f time= %10.2f ratio= %lld / %lld cycle=",
+                 lambda, total_time, cycle.total_weight, cycle.total_length );
+    else
+        fprintf( out, "final max_lambda= %10.2f time= %10.2f ratio= %lld / %lld cycle=",
+                 -lambda, total_time, -cycle.total_weight, cycle.total_length );
+    for ( int i = 0; i < cycle.len; ++i )
+        fprintf( out, " %d", gr->g.orig_edge( cycle.edges[ i ] ) + 1 );
+    fprintf( out, "\n" );
+}  // do_solve
+
+// Serve the requests of one connection. Return false if the server
+// should stop.
+static
+bool
+serve( int fd )
+{
+    FILE *in = fdopen( fd, "r" );
+    FILE *out = fdopen( dup( fd ), "w" );
+    bool keep_running = true;
+
+    char line[ MAX_LINE_SIZE + 1 ];
+    while ( fgets( line, sizeof( line ), in ) ) {
+        char *last;
+        char *cmd = strtok_r( line, " \t\r\n", &last );
+        char *arg[ 4 ];
+        int  nargs = 0;
+        while ( ( nargs < 4 ) && ( arg[ nargs ] = strtok_r( NULL, " \t\r\n", &last ) ) )
+            ++nargs;
+
+        if ( NULL == cmd ) {
+            fprintf( out, "error empty request\n" );
+        } else if ( !strcmp( cmd, "quit" ) ) {
+            break;
+        } else if ( !strcmp( cmd, "shutdown" ) ) {
+            keep_running = false;
+            break;
+        } else if ( !strcmp( cmd, "list" ) ) {
+            fprintf( out, "ok" );
+            for ( int i = 0; i < MAX_GRAPHS; ++i ) {
+                if ( graphs[ i ] )
+                    fprintf( out, " %s", graphs[ i ]->name );
+            }
+            fprintf( out, "\n" );
+        } else if ( !strcmp( cmd, "load" ) && ( 2 == nargs ) ) {
+            do_load( out, arg[ 0 ], arg[ 1 ] );
+        } else if ( ( !strcmp( cmd, "update" ) && ( 3 <= nargs ) ) ||
+                    ( !strcmp( cmd, "solve" ) && ( 2 <= nargs ) ) ||
+                    ( !strcmp( cmd, "unload" ) && ( 1 == nargs ) ) ) {
+            int i = find_graph( arg[ 0 ] );
+            if ( -1 == i ) {
+                fprintf( out, "error no graph %s\n", arg[ 0 ] );
+            } else if ( !strcmp( cmd, "unload" ) ) {
+                free_graph( i );
+                fprintf( out, "ok\n" );
+            } else if ( !strcmp( cmd, "update" ) ) {
+                int e, w, t = 1;
+                if ( !parse_int_arg( arg[ 1 ], e ) || !parse_int_arg( arg[ 2 ], w ) ||
+                     ( ( 4 == nargs ) && !parse_int_arg( arg[ 3 ], t ) ) )
+                    fprintf( out, "error expected integers E W [T]\n" );
+                else
+                    do_update( out, graphs[ i ], e, w, ( 4 == nargs ), t );
+            } else if ( !strcmp( arg[ 1 ], "min" ) || !strcmp( arg[ 1 ], "max" ) ) {
+                do_solve( out, graphs[ i ], !strcmp( arg[ 1 ], "min" ),
+                          ( 3 <= nargs ? arg[ 2 ] : NULL ) );
+            } else {
+                fprintf( out, "error expected min or max\n" );
+            }
+        } else {
+            fprintf( out, "error bad request %s\n", cmd );
+        }
+        fflush( out );
+    }
+
+    fclose( out );
+    fclose( in );
+
+    return keep_running;
+}  // serve
+
+// Fill addr for the socket file socket_file.
+static
+void
+set_address( struct sockaddr_un& addr, const char *socket_file )
+{
+    if ( sizeof( addr.sun_path ) <= strlen( socket_file ) ) {
+        printf( "ERROR: Socket file name %s is too long.\n", socket_file );
+        exit( 1 );
+    }
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sun_family = AF_UNIX;
+    strcpy( addr.sun_path, socket_file );
+}  // set_address
+
+static
+int
+run_server( const char *socket_file )
+{
+    struct sockaddr_un addr;
+    set_address( addr, socket_file );
+
+    int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    unlink( socket_file );
+    if ( ( -1 == fd ) ||
+         bind( fd, ( struct sockaddr * ) &addr, sizeof( addr ) ) ||
+         listen( fd, 8 ) ) {
+        printf( "ERROR: Cannot listen on %s: %s.\n", socket_file, strerror( errno ) );
+        exit( 1 );
+    }
+
+    // A client that goes away before its reply must not stop us.
+    signal( SIGPIPE, SIG_IGN );
+
+    bool keep_running = true;
+    while ( keep_running ) {
+        int conn = accept( fd, NULL, NULL );
+        if ( -1 == conn ) {
+            if ( EINTR == errno )
+                continue;
+            printf( "ERROR: Cannot accept on %s: %s.\n", socket_file, strerror( errno ) );
+            break;
+        }
+        keep_running = serve( conn );
+    }
+
+    close( fd );
+    unlink( socket_file );
+
+    for ( int i = 0; i < MAX_GRAPHS; ++i ) {
+        if ( graphs[ i ] )
+            free_graph( i );
+    }
+
+    return 0;
+}  // run_server
+
+// Send each line of stdin to the server and print its reply.
+static
+int
+run_client( const char *socket_file )
+{
+    struct sockaddr_un addr;
+    set_address( addr, socket_file );
+
+    int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( ( -1 == fd ) || connect( fd, ( struct sockaddr * ) &addr, sizeof( addr ) ) ) {
+        printf( "ERROR: Cannot connect to %s: %s.\n", socket_file, strerror( errno ) );
+        exit( 1 );
+    }
+
+    FILE *in = fdopen( fd, "r" );
+    FILE *out = fdopen( dup( fd ), "w" );
+
+    char line[ MAX_LINE_SIZE + 1 ];
+    while ( fgets( line, sizeof( line ), stdin ) ) {
+        fputs( line, out );
+        fflush( out );
+
+        // quit and shutdown get no reply.
+        if ( !strncmp( line, "quit", 4 ) || !strncmp( line, "shutdown", 8 ) )
+            break;
+
+        // A reply, e.g., with a long cycle, can take many reads.
+        do {
+            if ( NULL == fgets( line, sizeof( line ), in ) ) {
+                printf( "ERROR: The server closed the connection.\n" );
+                exit( 1 );
+            }
+            fputs( line, stdout );
+        } while ( NULL == strchr( line, '\n' ) );
+    }
+
+    fclose( out );
+    fclose( in );
+
+    return 0;
+}  // run_client
+
+int
+main( int argc, char *argv[] )
+{
+    if ( ( 3 == argc ) && !strcmp( argv[ 1 ], "-c" ) )
+        return run_client( argv[ 2 ] );
+
+    if ( ( 4 == argc ) && !strncmp( argv[ 2 ], "-t", 2 ) ) {
+        nthreads = atoi( argv[ 3 ] );
+    } else if ( 2 != argc ) {
+        printf( "Usage: %s socket_file [-t/hreads nthreads]\n", argv[ 0 ] );
+        printf( "       %s -c socket_file\n", argv[ 0 ] );
+        exit( 1 );
+    }
+    if ( ( 4 == argc ) && ( nthreads <= 0 ) ) {
+        printf( "ERROR: Require 'nthreads > 0'.\n" );
+        exit( 1 );
+    }
+
+    return run_server( argv[ 1 ] );
+}  // main
+
+// End of file
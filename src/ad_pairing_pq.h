@@ -0,0 +1,239 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+#ifndef AD_PAIRING_PQ_INCLUDED
+#define AD_PAIRING_PQ_INCLUDED
+
+#include "ad_globals.h"
+
+// A min priority queue implementation based on pairing heaps. It has
+// the same interface as ad_pq.
+//
+// The heap is a tree in which each node has a key no smaller than the
+// key of its parent. The children of a node are kept in a list: a node
+// points to its leftmost child, each child points to its right
+// sibling, and each child points back to its left sibling or, if it is
+// the leftmost child, to its parent. Decreasing a key cuts the node
+// with its subtree and melds it with the root in O(1) time. Increasing
+// a key removes the node, melding its children in two passes, and
+// reinserts it.
+//
+// As in ad_pq, a node is known by its handle, its number in the order
+// of insertion, and the node fields are kept in arrays indexed by the
+// handle.
+
+template< class key_t, class info_t >
+class ad_pairing_pq {
+public:
+
+    // Handle of a heap node.
+    typedef int ad_pq_handle;
+
+    // Constructors.
+    ad_pairing_pq()
+    {
+        alloc( MAX_ALLOC_SIZE );
+    }
+
+    ad_pairing_pq( int n )
+    {
+        alloc( n + 1 );
+    }
+
+    // Destructor.
+    ~ad_pairing_pq()
+    {
+        delete [] node_key;
+        delete [] node_info;
+        delete [] child;
+        delete [] sibling;
+        delete [] prev;
+    }
+
+    // Insert (key, info) into the heap and return the handle of its
+    // node.
+    ad_pq_handle put( const key_t& key, const info_t& info )
+    {
+        if ( len <= nnodes )
+            resize();
+
+        int h = nnodes++;
+        node_key[ h ] = key;
+        node_info[ h ] = info;
+        child[ h ] = sibling[ h ] = prev[ h ] = NIL;
+        root = ( NIL == root ? h : meld( root, h ) );
+
+        return h;
+    }  // put
+
+    // Update node h's key.
+    void update_key( const key_t& key, ad_pq_handle h )
+    {
+        if ( key < node_key[ h ] ) {
+            node_key[ h ] = key;
+            if ( h != root ) {
+                cut( h );
+                root = meld( root, h );
+            }
+        } else if ( key > node_key[ h ] ) {
+            node_key[ h ] = key;
+
+            // Remove h and meld its children back into the heap.
+            int t = merge_pairs( child[ h ] );
+            child[ h ] = NIL;
+            if ( h == root ) {
+                root = t;
+            } else {
+                cut( h );
+                if ( NIL != t )
+                    root = meld( root, t );
+            }
+
+            // Reinsert h alone.
+            root = ( NIL == root ? h : meld( root, h ) );
+        }
+        /* else do nothing */
+    }  // update_key
+
+    // Update node h's all information.
+    void update_node( const key_t& key, const info_t& info, ad_pq_handle h )
+    {
+        node_info[ h ] = info;
+        update_key( key, h );
+    }
+
+    // Return the properties of the min node:
+    key_t getkey()
+    {
+#ifdef DEBUG
+        assert( NIL != root );
+#endif
+        return node_key[ root ];
+    }
+    info_t getinfo()
+    {
+#ifdef DEBUG
+        assert( NIL != root );
+#endif
+        return node_info[ root ];
+    }
+
+private:
+    static const int NIL = -1;
+
+    int len;         // Size of the arrays.
+    int nnodes;      // Number of nodes ever inserted.
+    int root;        // The min node, or NIL if the heap is empty.
+
+    // Node h has key node_key[h] and info node_info[h]. Its leftmost
+    // child is child[h] and its right sibling is sibling[h]. prev[h] is
+    // its left sibling, or its parent if h is a leftmost child, or NIL
+    // if h is a root.
+    key_t  *node_key;
+    info_t *node_info;
+    int    *child;
+    int    *sibling;
+    int    *prev;
+
+private:
+    void alloc( int n )
+    {
+        nnodes = 0;
+        root = NIL;
+        len = max( n, 2 );
+        node_key = new key_t[ len ];
+        node_info = new info_t[ len ];
+        child = new int[ len ];
+        sibling = new int[ len ];
+        prev = new int[ len ];
+    }  // alloc
+
+    // Meld two trees with roots a and b, and return the root of the
+    // result. The root with the larger key becomes the leftmost child
+    // of the other.
+    int meld( int a, int b )
+    {
+        if ( node_key[ b ] < node_key[ a ] ) {
+            int tmp = a;
+            a = b;
+            b = tmp;
+        }
+        int c = child[ a ];
+        sibling[ b ] = c;
+        if ( NIL != c )
+            prev[ c ] = b;
+        prev[ b ] = a;
+        child[ a ] = b;
+        return a;
+    }  // meld
+
+    // Cut the subtree rooted at non-root node h from its tree.
+    void cut( int h )
+    {
+        int p = prev[ h ];
+        int s = sibling[ h ];
+        if ( child[ p ] == h )
+            child[ p ] = s;
+        else
+            sibling[ p ] = s;
+        if ( NIL != s )
+            prev[ s ] = p;
+        sibling[ h ] = prev[ h ] = NIL;
+    }  // cut
+
+    // Meld the list of trees starting at first into one tree in two
+    // passes, and return its root. The first pass melds pairs from left
+    // to right, and the second pass melds the results from right to
+    // left.
+    int merge_pairs( int first )
+    {
+        if ( NIL == first )
+            return NIL;
+
+        // First pass. The results are linked in reverse through sibling.
+        int list = NIL;
+        while ( NIL != first ) {
+            int a = first;
+            int b = sibling[ a ];
+            prev[ a ] = NIL;
+            if ( NIL == b ) {
+                sibling[ a ] = list;
+                list = a;
+                break;
+            }
+            first = sibling[ b ];
+            prev[ b ] = NIL;
+            sibling[ a ] = sibling[ b ] = NIL;
+            a = meld( a, b );
+            sibling[ a ] = list;
+            list = a;
+        }
+
+        // Second pass.
+        int r = list;
+        list = sibling[ r ];
+        sibling[ r ] = NIL;
+        while ( NIL != list ) {
+            int next = sibling[ list ];
+            sibling[ list ] = NIL;
+            r = meld( r, list );
+            list = next;
+        }
+
+        return r;
+    }  // merge_pairs
+
+    // Resize the arrays by MAX_ALLOC_SIZE.
+    void resize()
+    {
+        int old_len = len;
+        len += MAX_ALLOC_SIZE;
+        resize_table( node_key, old_len, len );
+        resize_table( node_info, old_len, len );
+        resize_table( child, old_len, len );
+        resize_table( sibling, old_len, len );
+        resize_table( prev, old_len, len );
+    }  // resize
+};  // ad_pairing_pq
+
+#endif
@@ -4,8 +4,19 @@
 //#include "new.h"
 #include <new>
 #include "ad_pq.h"
+#include "ad_pairing_pq.h"
+#include "ad_fib_pq.h"
 
 // Instantiate instances of ad_pq with types.
 template class ad_pq< int, int >;
 template class ad_pq< float, int >;
+template class ad_pq< float, int, 4 >;
+template class ad_pairing_pq< float, int >;
+template class ad_fib_pq< float, int >;
+
+// The keys of the 64-bit numeric policy (see ad_solver_pq.h).
+template class ad_pq< double, int >;
+template class ad_pq< double, int, 4 >;
+template class ad_pairing_pq< double, int >;
+template class ad_fib_pq< double, int >;
 // End of file
@@ -6,129 +6,103 @@
 
 #include "ad_globals.h"
 
-// A min priority queue implementation based on binary heaps.
+// A min priority queue implementation based on d-ary heaps, where d
+// is arity: 2 for binary heaps, 4 for 4-ary heaps, etc.
+//
+// The nodes are not allocated one by one. A node is known by its
+// handle, which is its number in the order of insertion, and its info
+// and heap position are kept in arrays indexed by the handle. The keys
+// are kept in the heap array itself, next to the handles, so the heap
+// operations compare keys without following any pointer.
 
-template< class key_t, class info_t >
+template< class key_t, class info_t, int arity = 2 >
 class ad_pq {
 public:
 
-    // Structure of a heap node.
-    struct ad_pq_node {
-        key_t  key;   // Ordering is on this key.
-        info_t info;  // Extra info.
-        int pos;      // If heap[i] points to this node, pos is i.
-
-        // Constructors:
-        ad_pq_node()
-        {        
-            /*EMPTY*/
-        }
-        ad_pq_node( const ad_pq_node& rhs )
-        {
-            key = rhs.key;
-            info = rhs.info;
-            pos = rhs.pos;
-        }
-        ad_pq_node( const key_t& k, const info_t& i, int p )
-        {
-            key = k;
-            info = i;
-            pos = p;
-        }
-
-        ad_pq_node& operator=( const ad_pq_node& rhs )
-        {
-            if ( this != &rhs ) {
-                key = rhs.key;
-                info = rhs.info;
-                pos = rhs.pos;
-            }
-            return *this;
-        }
-    };
-
-    typedef ad_pq_node* ad_pq_node_ptr;
+    // Handle of a heap node.
+    typedef int ad_pq_handle;
 
     // Constructors.
     ad_pq()
     {
-        hsize = 0;
-        len = MAX_ALLOC_SIZE;
-        heap = new ad_pq_node_ptr[ len ];
+        alloc( MAX_ALLOC_SIZE );
     }
 
     ad_pq( int n )
     {
-        hsize = 0;
-        len = n;
-        heap = new ad_pq_node_ptr[ len ];
+        alloc( n + 1 );
     }
 
     // Destructor.
     ~ad_pq()
     {
-        for ( int i = 1; i <= hsize; ++i )
-            delete heap[ i ];
-        delete [] heap;
+        delete [] heap_key;
+        delete [] heap_node;
+        delete [] node_info;
+        delete [] node_pos;
     }
 
-    // Insert (key, info) into the heap.
-    ad_pq_node_ptr put( const key_t& key, const info_t& info )
+    // Insert (key, info) into the heap and return the handle of its
+    // node.
+    ad_pq_handle put( const key_t& key, const info_t& info )
     {
         ++hsize;
+        int h = nnodes++;
 
         // Resize heap if it does not have enough space.
-        if ( len <= hsize )
+        if ( len <= nnodes )
             resize();
 
+        node_info[ h ] = info;
+
         // Move nodes down until a suitable place for (key, info) is
-        // found. This loop is similar to sift_up but the latter uses
-        // exchanges rather than copies.
+        // found.
         int i = hsize;
-        while ( ( i > 1 ) && ( key < heap[ parent( i ) ]->key ) ) {
+        while ( ( i > 1 ) && ( key < heap_key[ parent( i ) ] ) ) {
             int p = parent( i );
             copy( i, p );
             i = p;
         }
-        heap[ i ] = new ad_pq_node( key, info, i );
+        place( i, key, h );
 
-        return heap[ i ];
+        return h;
     }  // put
 
-    // Update node ptr's key.
-    void update_key( const key_t& key, ad_pq_node_ptr ptr )
+    // Update node h's key.
+    void update_key( const key_t& key, ad_pq_handle h )
     {
-        if ( key < ptr->key ) {
-            ptr->key = key;
-            sift_up( ptr->pos );
-        } else if ( key > ptr->key ) {
-            ptr->key = key;
-            sift_down( ptr->pos );
+        int i = node_pos[ h ];
+        if ( key < heap_key[ i ] ) {
+            heap_key[ i ] = key;
+            sift_up( i );
+        } else if ( key > heap_key[ i ] ) {
+            heap_key[ i ] = key;
+            sift_down( i );
         }
         /* else do nothing */
     }  // update_key
 
-    // Update node ptr's all information.
-    void update_node( const key_t& key, const info_t& info, ad_pq_node_ptr ptr )
+    // Update node h's all information.
+    void update_node( const key_t& key, const info_t& info, ad_pq_handle h )
     {
-        ptr->info = info;
-        update_key( key, ptr );
+        node_info[ h ] = info;
+        update_key( key, h );
     }
 
     // Return the properties of the min node:
-    key_t getkey() 
+    key_t getkey()
     {
 #ifdef DEBUG
         assert( hsize > 0 );
 #endif
-        return heap[ 1 ]->key;
+        return heap_key[ 1 ];
     }
     info_t getinfo()
     {
 #ifdef DEBUG
         assert( hsize > 0 );
 #endif
-        return heap[ 1 ]->info;
+        return node_info[ heap_node[ 1 ] ];
     }
 
 #if 0
@@ -137,16 +111,14 @@ public:
     // Delete the node with the min key.
     void del_min()
     {
-        delete heap[ 1 ];
         copy( 1, hsize-- );
         sift_down( 1 );
     }
 
-    // Delete the node ptr.
-    void del( ad_pq_node_ptr ptr )
+    // Delete the node h.
+    void del( ad_pq_handle h )
     {
-        int i = ptr->pos;
-        delete heap[ i ];
+        int i = node_pos[ h ];
         copy( i, hsize-- );
         sift_down( i );
     }
@@ -163,99 +135,122 @@ public:
 #endif
 
 private:
-    int len;         // Size of array holding heap.
+    int len;         // Size of the arrays.
     int hsize;       // Number of nodes in heap.
+    int nnodes;      // Number of nodes ever inserted.
+
+    // The heap is in heap_key[1], ..., heap_key[hsize] and
+    // heap_node[1], ..., heap_node[hsize], where index 1 is the root
+    // of the heap, the min node in the heap. Index i holds the key and
+    // the handle of its node. Note that len must be larger than
+    // hsize. Also note that the heap property implies
+    // heap_key[parent(i)] <= heap_key[i].
+    key_t  *heap_key;
+    int    *heap_node;
 
-    // Nodes are pointed to by pointers in heap[1], heap[2], ...,
-    // heap[hsize], where heap[1] points to the root of the heap, the
-    // min node in the heap. Note that len must be larger than
-    // hsize. Also note that the heap property implies heap[i] <=
-    // min(heap[left(i)], heap[right(i)]), or heap[parent(i)] <=
-    // heap[i].
-    ad_pq_node_ptr *heap;
+    // Node h has info node_info[h] and is at heap index node_pos[h].
+    info_t *node_info;
+    int    *node_pos;
 
 private:
+    void alloc( int n )
+    {
+        hsize = 0;
+        nnodes = 0;
+        len = max( n, 2 );
+        heap_key = new key_t[ len ];
+        heap_node = new int[ len ];
+        node_info = new info_t[ len ];
+        node_pos = new int[ len ];
+    }  // alloc
+
     // Check if i is valid.
     void check_inx( int i ) const
     {
         assert( ( 1 <= i ) && ( i <= hsize ) );
     }
 
-    // Return parent, left child, or right child of node i:
+    // Return parent or first child of node i. The children of i are
+    // first_child(i), ..., first_child(i) + arity - 1.
     int parent( int i ) const
     {
-        return ( i >> 1 );
+        return ( ( unsigned ) ( i - 2 ) / arity ) + 1;
     }
-    int left( int i ) const
+    int first_child( int i ) const
     {
-        return ( i << 1 );
-    }
-    int right( int i ) const
-    {
-        return ( i << 1 ) + 1;
+        return arity * ( i - 1 ) + 2;
     }
 
-    // Copy node j to node i.
-    void copy( int i, int j ) 
+    // Put node h with the given key at index i.
+    void place( int i, const key_t& key, int h )
     {
-        heap[ i ] = heap[ j ];
-        heap[ i ]->pos = i;
+        heap_key[ i ] = key;
+        heap_node[ i ] = h;
+        node_pos[ h ] = i;
     }
 
-    // Exchange node j with node i.
-    void exchange( int i, int j )
+    // Copy index j to index i.
+    void copy( int i, int j )
     {
-        heap[ 0 ] = heap[ i ];
-        copy( i, j );
-        copy( j, 0 );
+        place( i, heap_key[ j ], heap_node[ j ] );
     }
 
-    // Move up thru exchanges starting from node i.
+    // Move up starting from index i. The nodes above are moved down
+    // into the hole until the node at i fits.
     void sift_up( int i )
     {
 #ifdef DEBUG
         check_inx( i );
 #endif
-        int p = parent( i );
-        while ( ( i > 1 ) && ( heap[ i ]->key < heap[ p ]->key ) ) {
-            exchange( i, p );
+        key_t key = heap_key[ i ];
+        int   h = heap_node[ i ];
+        int   p = parent( i );
+        while ( ( i > 1 ) && ( key < heap_key[ p ] ) ) {
+            copy( i, p );
             i = p;
             p = parent( p ); // i can also be used as an argument.
         }
+        place( i, key, h );
     }  // sift_up
 
-    // Move down thru exchanges starting from node i.
+    // Move down starting from index i. The smaller children are moved
+    // up into the hole until the node at i fits.
     void sift_down( int i )
     {
 #ifdef DEBUG
         check_inx( i );
 #endif
-        int l;
-        while ( l = left( i ), l <= hsize ) {
-            // smallest = min(heap[i], heap[left(i)], heap[right(i)]).
-            int smallest = ( ( heap[ l ]->key < heap[ i ]->key ) ? l : i );
-            int r = right( i );
-            if ( ( r <= hsize ) && ( heap[ r ]->key < heap[ smallest ]->key ) )
-                smallest = r;
-
-            if ( smallest != i ) {
-                exchange( i, smallest );
+        key_t key = heap_key[ i ];
+        int   h = heap_node[ i ];
+        int c;
+        while ( c = first_child( i ), c <= hsize ) {
+            // smallest = argmin of the keys of the children of i.
+            int smallest = c;
+            int last = min( c + arity - 1, hsize );
+            for ( ++c; c <= last; ++c ) {
+                if ( heap_key[ c ] < heap_key[ smallest ] )
+                    smallest = c;
+            }
+
+            if ( heap_key[ smallest ] < key ) {
+                copy( i, smallest );
                 i = smallest;
             }
             else
                 break;
         }
+        place( i, key, h );
     }  // sift_down
 
-    // Resize heap's size by MAX_ALLOC_SIZE.
+    // Resize the arrays by MAX_ALLOC_SIZE.
     void resize()
     {
+        int old_len = len;
         len += MAX_ALLOC_SIZE;
-        ad_pq_node_ptr *new_heap = new ad_pq_node_ptr[ len ];
-        for ( int j = 1; j < hsize; ++j )
-            new_heap[ j ] = heap[ j ];
-        delete [] heap;
-        heap = new_heap;
+        resize_table( heap_key, old_len, len );
+        resize_table( heap_node, old_len, len );
+        resize_table( node_info, old_len, len );
+        resize_table( node_pos, old_len, len );
     }  // resize
 };  // ad_pq
 
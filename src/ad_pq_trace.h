@@ -0,0 +1,120 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+#ifndef AD_PQ_TRACE_INCLUDED
+#define AD_PQ_TRACE_INCLUDED
+
+#include <stdlib.h>
+#include "ad_globals.h"
+
+// Recording the operations done on a priority queue so that they can
+// be replayed on other priority queues (see ad_pqbench.cc).
+//
+// A trace is a file of pq_trace_rec records, written in the order of
+// the operations. Handles are numbers in the order of insertion for
+// every priority queue in this package, so a handle in a trace is
+// valid for any of them.
+
+// Operation codes.
+const char PQ_OP_NEW     = 'C';  // Construct with size in handle.
+const char PQ_OP_DELETE  = 'D';  // Destruct.
+const char PQ_OP_PUT     = 'P';  // Put (key, info), returning handle.
+const char PQ_OP_KEY     = 'K';  // Update key of handle.
+const char PQ_OP_NODE    = 'N';  // Update key and info of handle.
+const char PQ_OP_GETKEY  = 'M';  // Get the min key.
+const char PQ_OP_GETINFO = 'I';  // Get the min info.
+
+typedef struct {
+    char  op;
+    int   handle;
+    float key;
+    int   info;
+} pq_trace_rec;
+
+// The trace file, named by the PQ_TRACE_FILE environment variable or
+// pq.trace by default.
+inline
+FILE *
+pq_trace_file()
+{
+    static FILE *fp = NULL;
+    if ( NULL == fp ) {
+        const char *name = getenv( "PQ_TRACE_FILE" );
+        if ( NULL == name )
+            name = "pq.trace";
+        fp = fopen( name, "wb" );
+        if ( NULL == fp ) {
+            printf( "ERROR: Cannot open the trace file %s.\n", name );
+            abort();
+        }
+    }
+    return fp;
+}  // pq_trace_file
+
+inline
+void
+pq_trace( char op, int handle, float key, int info )
+{
+    pq_trace_rec rec;
+    memset( &rec, 0, sizeof( rec ) );
+    rec.op = op;
+    rec.handle = handle;
+    rec.key = key;
+    rec.info = info;
+    fwrite( &rec, sizeof( rec ), 1, pq_trace_file() );
+}  // pq_trace
+
+// A priority queue of type pq_t that records its operations. pq_t has
+// keys of type key_t and int infos. The keys are recorded as floats.
+template< class pq_t, class key_t = float >
+class ad_traced_pq {
+public:
+
+    typedef typename pq_t::ad_pq_handle ad_pq_handle;
+
+    ad_traced_pq( int n ) : pq( n )
+    {
+        pq_trace( PQ_OP_NEW, n, 0, 0 );
+    }
+
+    ~ad_traced_pq()
+    {
+        pq_trace( PQ_OP_DELETE, 0, 0, 0 );
+    }
+
+    ad_pq_handle put( key_t key, int info )
+    {
+        ad_pq_handle h = pq.put( key, info );
+        pq_trace( PQ_OP_PUT, h, key, info );
+        return h;
+    }
+
+    void update_key( key_t key, ad_pq_handle h )
+    {
+        pq_trace( PQ_OP_KEY, h, key, 0 );
+        pq.update_key( key, h );
+    }
+
+    void update_node( key_t key, int info, ad_pq_handle h )
+    {
+        pq_trace( PQ_OP_NODE, h, key, info );
+        pq.update_node( key, info, h );
+    }
+
+    key_t getkey()
+    {
+        pq_trace( PQ_OP_GETKEY, 0, 0, 0 );
+        return pq.getkey();
+    }
+
+    int getinfo()
+    {
+        pq_trace( PQ_OP_GETINFO, 0, 0, 0 );
+        return pq.getinfo();
+    }
+
+private:
+    pq_t pq;
+};  // ad_traced_pq
+
+#endif
@@ -0,0 +1,120 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+// Replay a priority queue trace (see ad_pq_trace.h) on each priority
+// queue implementation and report the time each takes. A trace is
+// recorded by running kotrace.x or ytotrace.x, the versions of ko.x and
+// yto.x built with -DPQ_TRACE. See upqbench.sh.
+//
+// Usage: pqbench.x trace_file [nreps]
+
+#include "ad_pq.h"
+#include "ad_pairing_pq.h"
+#include "ad_fib_pq.h"
+#include "ad_pq_trace.h"
+#include "ad_util.h"
+
+// Replay the n records in trace on queues of type pq_t nreps
+// times. Return the time taken; the sum of the min keys seen is
+// returned in key_sum, which must be the same for every pq_t.
+template< class pq_t >
+float
+replay( const pq_trace_rec *trace, int n, int nreps, double& key_sum )
+{
+    float total_time = used_time();
+    for ( int rep = 0; rep < nreps; ++rep ) {
+        pq_t *pq = NULL;
+        key_sum = 0;
+        for ( int i = 0; i < n; ++i ) {
+            const pq_trace_rec *rec = &trace[ i ];
+            switch ( rec->op ) {
+            case PQ_OP_NEW:
+                delete pq;
+                pq = new pq_t( rec->handle );
+                break;
+            case PQ_OP_DELETE:
+                delete pq;
+                pq = NULL;
+                break;
+            case PQ_OP_PUT:
+                {
+                    int h = pq->put( rec->key, rec->info );
+                    if ( h != rec->handle ) {
+                        printf( "ERROR: Handle mismatch in the trace.\n" );
+                        abort();
+                    }
+                }
+                break;
+            case PQ_OP_KEY:
+                pq->update_key( rec->key, rec->handle );
+                break;
+            case PQ_OP_NODE:
+                pq->update_node( rec->key, rec->info, rec->handle );
+                break;
+            case PQ_OP_GETKEY:
+                key_sum += pq->getkey();
+                break;
+            case PQ_OP_GETINFO:
+                pq->getinfo();
+                break;
+            default:
+                printf( "ERROR: Unknown operation %c in the trace.\n", rec->op );
+                abort();
+            }
+        }
+        delete pq;
+    }
+    return used_time() - total_time;
+}  // replay
+
+int
+main( int argc, char *argv[] )
+{
+    if ( ( 2 > argc ) || ( 3 < argc ) ) {
+        printf( "Usage: %s trace_file [nreps]\n", argv[ 0 ] );
+        exit( 1 );
+    }
+    int nreps = ( 3 == argc ? atoi( argv[ 2 ] ) : 1 );
+
+    size_t size;
+    char *data = map_file( argv[ 1 ], size );
+    if ( NULL == data )
+        exit( 1 );
+    const pq_trace_rec *trace = ( const pq_trace_rec * ) data;
+    int n = size / sizeof( pq_trace_rec );
+
+    // Count the operations.
+    int nputs = 0, nupdates = 0, nmins = 0;
+    for ( int i = 0; i < n; ++i ) {
+        switch ( trace[ i ].op ) {
+        case PQ_OP_PUT:
+            ++nputs;
+            break;
+        case PQ_OP_KEY: case PQ_OP_NODE:
+            ++nupdates;
+            break;
+        case PQ_OP_GETKEY:
+            ++nmins;
+            break;
+        }
+    }
+    printf( "puts= %d updates= %d mins= %d\n", nputs, nupdates, nmins );
+
+    double key_sum;
+    float  t;
+
+    t = replay< ad_pq< float, int > >( trace, n, nreps, key_sum );
+    printf( "heap= binary    time= %10.2f key_sum= %g\n", t, key_sum );
+    t = replay< ad_pq< float, int, 4 > >( trace, n, nreps, key_sum );
+    printf( "heap= 4-ary     time= %10.2f key_sum= %g\n", t, key_sum );
+    t = replay< ad_pairing_pq< float, int > >( trace, n, nreps, key_sum );
+    printf( "heap= pairing   time= %10.2f key_sum= %g\n", t, key_sum );
+    t = replay< ad_fib_pq< float, int > >( trace, n, nreps, key_sum );
+    printf( "heap= fibonacci time= %10.2f key_sum= %g\n", t, key_sum );
+
+    unmap_file( data, size );
+
+    return 0;
+}  // main
+
+// End of file
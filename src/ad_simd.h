@@ -0,0 +1,249 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+#ifndef AD_SIMD_INCLUDED
+#define AD_SIMD_INCLUDED
+
+// Vectorized kernels with a scalar fallback. The instruction set is
+// chosen at runtime: AVX-512 if the CPU has it, AVX2 otherwise, and the
+// scalar code on other CPUs, on other architectures, or if NO_SIMD is
+// defined.
+
+#include <limits.h>
+#include <math.h>
+
+#include "ad_globals.h"
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ ) && !defined( NO_SIMD )
+#define AD_SIMD_X86
+#include <immintrin.h>
+#endif
+
+enum {
+    AD_SIMD_NONE = 0,
+    AD_SIMD_AVX2 = 1,
+    AD_SIMD_AVX512 = 2
+};
+
+// Return the best instruction set of the CPU, found once.
+inline
+int
+ad_simd_cpu_level()
+{
+#ifdef AD_SIMD_X86
+    static const int level = ( __builtin_cpu_supports( "avx512f" ) ? AD_SIMD_AVX512 :
+                               __builtin_cpu_supports( "avx2" ) ? AD_SIMD_AVX2 : AD_SIMD_NONE );
+    return level;
+#else
+    return AD_SIMD_NONE;
+#endif
+}  // ad_simd_cpu_level
+
+// Return the instruction set for ad_find_improving_edge on nodes of nbytes in
+// total: the kernels gather with 32-bit byte offsets, so larger node
+// arrays take the scalar code.
+inline
+int
+ad_simd_level( long long nbytes )
+{
+    return ( nbytes <= INT_MAX ? ad_simd_cpu_level() : AD_SIMD_NONE );
+}  // ad_simd_level
+
+///////////////////////////////////////////////////////////////////////
+// Search for an improving edge:
+//
+// ad_find_improving_edge( level, dist, stride, src, tar, delta, w, t,
+// from, to, lambda ) returns the first e of from, ..., to-1 with
+// EPSILON < d(u) - ( d(v) + w[ e ] - lambda * t[ e ] ), where u =
+// src[ e ] - delta, v = tar[ e ] - delta, and d(u) is the dist_t at the
+// byte offset u * stride from dist, i.e., the dist field of node u in
+// an array of node infos, or to if there is none. t is NULL if every
+// transit time is 1. The vector code computes each difference with the
+// same operations in the same order as the scalar code does. The
+// kernels are compiled with fp-contract off, because the AVX-512 target
+// has FMA, and the compiler would otherwise fuse lambda * t[ e ] and its
+// subtraction into one rounding at -O2 and above. The scalar code has
+// no FMA on the default target, so the result does not depend on level
+// unless the build targets a CPU with FMA, e.g., with -march=native,
+// which also needs -ffp-contract=off.
+
+template< class dist_t >
+inline
+dist_t
+ad_node_dist( const dist_t *dist, int stride, int v )
+{
+    return *( const dist_t * ) ( ( const char * ) dist + ( long ) v * stride );
+}  // ad_node_dist
+
+template< class dist_t >
+inline
+int
+ad_find_improving_edge_scalar( const dist_t *dist, int stride, const int *src, const int *tar,
+                               int delta, const int *w, const int *t, int from, int to,
+                               dist_t lambda )
+{
+    for ( int e = from; e < to; ++e ) {
+        dist_t new_dist = ad_node_dist( dist, stride, tar[ e ] - delta ) + w[ e ] -
+            ( t ? lambda * t[ e ] : lambda );
+        if ( EPSILON < ( ad_node_dist( dist, stride, src[ e ] - delta ) - new_dist ) )
+            return e;
+    }
+    return to;
+}  // ad_find_improving_edge_scalar
+
+#ifdef AD_SIMD_X86
+
+// AVX2: 8 floats or 4 doubles at a time.
+
+__attribute__(( target( "avx2" ), optimize( "fp-contract=off" ), unused ))
+static
+int
+ad_find_improving_edge_avx2( const float *dist, int stride, const int *src, const int *tar,
+                             int delta, const int *w, const int *t, int from, int to,
+                             float lambda )
+{
+    const __m256i vdelta = _mm256_set1_epi32( delta );
+    const __m256i vstride = _mm256_set1_epi32( stride );
+    const __m256  vlambda = _mm256_set1_ps( lambda );
+    const __m256  veps = _mm256_set1_ps( EPSILON );
+    const __m256  vall = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+
+    int e = from;
+    for ( ; e + 8 <= to; e += 8 ) {
+        __m256i uoff = _mm256_mullo_epi32( _mm256_sub_epi32( _mm256_loadu_si256( ( const __m256i * ) ( src + e ) ), vdelta ), vstride );
+        __m256i voff = _mm256_mullo_epi32( _mm256_sub_epi32( _mm256_loadu_si256( ( const __m256i * ) ( tar + e ) ), vdelta ), vstride );
+        __m256  d = _mm256_mask_i32gather_ps( _mm256_setzero_ps(), dist, voff, vall, 1 );
+        d = _mm256_add_ps( d, _mm256_cvtepi32_ps( _mm256_loadu_si256( ( const __m256i * ) ( w + e ) ) ) );
+        if ( t )
+            d = _mm256_sub_ps( d, _mm256_mul_ps( vlambda, _mm256_cvtepi32_ps( _mm256_loadu_si256( ( const __m256i * ) ( t + e ) ) ) ) );
+        else
+            d = _mm256_sub_ps( d, vlambda );
+        d = _mm256_sub_ps( _mm256_mask_i32gather_ps( _mm256_setzero_ps(), dist, uoff, vall, 1 ), d );
+
+        int mask = _mm256_movemask_ps( _mm256_cmp_ps( veps, d, _CMP_LT_OQ ) );
+        if ( mask )
+            return e + __builtin_ctz( mask );
+    }
+
+    return ad_find_improving_edge_scalar( dist, stride, src, tar, delta, w, t, e, to, lambda );
+}  // ad_find_improving_edge_avx2
+
+__attribute__(( target( "avx2" ), optimize( "fp-contract=off" ), unused ))
+static
+int
+ad_find_improving_edge_avx2( const double *dist, int stride, const int *src, const int *tar,
+                             int delta, const int *w, const int *t, int from, int to,
+                             double lambda )
+{
+    const __m128i vdelta = _mm_set1_epi32( delta );
+    const __m128i vstride = _mm_set1_epi32( stride );
+    const __m256d vlambda = _mm256_set1_pd( lambda );
+    const __m256d veps = _mm256_set1_pd( EPSILON );
+    const __m256d vall = _mm256_castsi256_pd( _mm256_set1_epi64x( -1 ) );
+
+    int e = from;
+    for ( ; e + 4 <= to; e += 4 ) {
+        __m128i uoff = _mm_mullo_epi32( _mm_sub_epi32( _mm_loadu_si128( ( const __m128i * ) ( src + e ) ), vdelta ), vstride );
+        __m128i voff = _mm_mullo_epi32( _mm_sub_epi32( _mm_loadu_si128( ( const __m128i * ) ( tar + e ) ), vdelta ), vstride );
+        __m256d d = _mm256_mask_i32gather_pd( _mm256_setzero_pd(), dist, voff, vall, 1 );
+        d = _mm256_add_pd( d, _mm256_cvtepi32_pd( _mm_loadu_si128( ( const __m128i * ) ( w + e ) ) ) );
+        if ( t )
+            d = _mm256_sub_pd( d, _mm256_mul_pd( vlambda, _mm256_cvtepi32_pd( _mm_loadu_si128( ( const __m128i * ) ( t + e ) ) ) ) );
+        else
+            d = _mm256_sub_pd( d, vlambda );
+        d = _mm256_sub_pd( _mm256_mask_i32gather_pd( _mm256_setzero_pd(), dist, uoff, vall, 1 ), d );
+
+        int mask = _mm256_movemask_pd( _mm256_cmp_pd( veps, d, _CMP_LT_OQ ) );
+        if ( mask )
+            return e + __builtin_ctz( mask );
+    }
+
+    return ad_find_improving_edge_scalar( dist, stride, src, tar, delta, w, t, e, to, lambda );
+}  // ad_find_improving_edge_avx2
+
+// AVX-512: 16 floats or 8 doubles at a time.
+
+__attribute__(( target( "avx512f" ), optimize( "fp-contract=off" ), unused ))
+static
+int
+ad_find_improving_edge_avx512( const float *dist, int stride, const int *src, const int *tar,
+                               int delta, const int *w, const int *t, int from, int to,
+                               float lambda )
+{
+    const __m512i vdelta = _mm512_set1_epi32( delta );
+    const __m512i vstride = _mm512_set1_epi32( stride );
+    const __m512  vlambda = _mm512_set1_ps( lambda );
+    const __m512  veps = _mm512_set1_ps( EPSILON );
+
+    int e = from;
+    for ( ; e + 16 <= to; e += 16 ) {
+        __m512i uoff = _mm512_mullo_epi32( _mm512_sub_epi32( _mm512_loadu_si512( src + e ), vdelta ), vstride );
+        __m512i voff = _mm512_mullo_epi32( _mm512_sub_epi32( _mm512_loadu_si512( tar + e ), vdelta ), vstride );
+        __m512  d = _mm512_mask_i32gather_ps( _mm512_setzero_ps(), 0xffff, voff, dist, 1 );
+        d = _mm512_add_ps( d, _mm512_maskz_cvtepi32_ps( 0xffff, _mm512_loadu_si512( w + e ) ) );
+        if ( t )
+            d = _mm512_sub_ps( d, _mm512_mul_ps( vlambda, _mm512_maskz_cvtepi32_ps( 0xffff, _mm512_loadu_si512( t + e ) ) ) );
+        else
+            d = _mm512_sub_ps( d, vlambda );
+        d = _mm512_sub_ps( _mm512_mask_i32gather_ps( _mm512_setzero_ps(), 0xffff, uoff, dist, 1 ), d );
+
+        __mmask16 mask = _mm512_cmp_ps_mask( veps, d, _CMP_LT_OQ );
+        if ( mask )
+            return e + __builtin_ctz( mask );
+    }
+
+    return ad_find_improving_edge_scalar( dist, stride, src, tar, delta, w, t, e, to, lambda );
+}  // ad_find_improving_edge_avx512
+
+__attribute__(( target( "avx512f" ), optimize( "fp-contract=off" ), unused ))
+static
+int
+ad_find_improving_edge_avx512( const double *dist, int stride, const int *src, const int *tar,
+                               int delta, const int *w, const int *t, int from, int to,
+                               double lambda )
+{
+    const __m256i vdelta = _mm256_set1_epi32( delta );
+    const __m256i vstride = _mm256_set1_epi32( stride );
+    const __m512d vlambda = _mm512_set1_pd( lambda );
+    const __m512d veps = _mm512_set1_pd( EPSILON );
+
+    int e = from;
+    for ( ; e + 8 <= to; e += 8 ) {
+        __m256i uoff = _mm256_mullo_epi32( _mm256_sub_epi32( _mm256_loadu_si256( ( const __m256i * ) ( src + e ) ), vdelta ), vstride );
+        __m256i voff = _mm256_mullo_epi32( _mm256_sub_epi32( _mm256_loadu_si256( ( const __m256i * ) ( tar + e ) ), vdelta ), vstride );
+        __m512d d = _mm512_mask_i32gather_pd( _mm512_setzero_pd(), 0xff, voff, dist, 1 );
+        d = _mm512_add_pd( d, _mm512_maskz_cvtepi32_pd( 0xff, _mm256_loadu_si256( ( const __m256i * ) ( w + e ) ) ) );
+        if ( t )
+            d = _mm512_sub_pd( d, _mm512_mul_pd( vlambda, _mm512_maskz_cvtepi32_pd( 0xff, _mm256_loadu_si256( ( const __m256i * ) ( t + e ) ) ) ) );
+        else
+            d = _mm512_sub_pd( d, vlambda );
+        d = _mm512_sub_pd( _mm512_mask_i32gather_pd( _mm512_setzero_pd(), 0xff, uoff, dist, 1 ), d );
+
+        __mmask8 mask = _mm512_cmp_pd_mask( veps, d, _CMP_LT_OQ );
+        if ( mask )
+            return e + __builtin_ctz( mask );
+    }
+
+    return ad_find_improving_edge_scalar( dist, stride, src, tar, delta, w, t, e, to, lambda );
+}  // ad_find_improving_edge_avx512
+
+#endif  // AD_SIMD_X86
+
+template< class dist_t >
+inline
+int
+ad_find_improving_edge( int level, const dist_t *dist, int stride, const int *src, const int *tar,
+                        int delta, const int *w, const int *t, int from, int to, dist_t lambda )
+{
+#ifdef AD_SIMD_X86
+    if ( AD_SIMD_AVX512 == level )
+        return ad_find_improving_edge_avx512( dist, stride, src, tar, delta, w, t, from, to, lambda );
+    if ( AD_SIMD_AVX2 == level )
+        return ad_find_improving_edge_avx2( dist, stride, src, tar, delta, w, t, from, to, lambda );
+#endif
+    return ad_find_improving_edge_scalar( dist, stride, src, tar, delta, w, t, from, to, lambda );
+}  // ad_find_improving_edge
+
+#endif
+
+// End of file
@@ -0,0 +1,58 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+#ifndef AD_SOLVER_PQ_INCLUDED
+#define AD_SOLVER_PQ_INCLUDED
+
+#include "ad_pq.h"
+#include "ad_pairing_pq.h"
+#include "ad_fib_pq.h"
+
+// The priority queue used by KO and YTO, selected at build time by
+// -DPQ_KIND=n, e.g., 'make ko PQ_KIND=2' after 'make cleano'. The
+// 4-ary heap is the default as it was the fastest in replays of KO and
+// YTO runs on sparse and dense graphs (see upqbench.sh). With
+// -DPQ_TRACE, the operations are also recorded (see ad_pq_trace.h).
+// ad_solver_pq< key_t >::type is the queue for keys of type key_t,
+// i.e., the dist_t of the numeric policy of the solver.
+
+#define PQ_BINARY   0
+#define PQ_4ARY     1
+#define PQ_PAIRING  2
+#define PQ_FIB      3
+
+#ifndef PQ_KIND
+#define PQ_KIND PQ_4ARY
+#endif
+
+#if ( PQ_KIND < PQ_BINARY ) || ( PQ_FIB < PQ_KIND )
+#error "PQ_KIND must be 0, 1, 2, or 3."
+#endif
+
+#ifdef PQ_TRACE
+#include "ad_pq_trace.h"
+#endif
+
+template< class key_t >
+struct ad_solver_pq {
+#if PQ_KIND == PQ_BINARY
+    typedef ad_pq< key_t, int > base_type;
+#elif PQ_KIND == PQ_4ARY
+    typedef ad_pq< key_t, int, 4 > base_type;
+#elif PQ_KIND == PQ_PAIRING
+    typedef ad_pairing_pq< key_t, int > base_type;
+#else
+    typedef ad_fib_pq< key_t, int > base_type;
+#endif
+
+#ifdef PQ_TRACE
+    typedef ad_traced_pq< base_type, key_t > type;
+#else
+    typedef base_type type;
+#endif
+};
+
+// The handles of every kind of queue are ints.
+typedef int ad_solver_pq_handle;
+
+#endif
@@ -0,0 +1,105 @@
+//
+// COPYRIGHT C 1999- Ali Dasdan (ali_dasdan@yahoo.com)
+//
+#ifndef AD_THREAD_INCLUDED
+#define AD_THREAD_INCLUDED
+
+#include <pthread.h>
+
+#include "ad_globals.h"
+
+// Thread support: a lambda shared by threads, a stop flag, and a
+// function to run a function on many threads.
+
+///////////////////////////////////////////////////////////////////////
+// Shared lambda class: the smallest lambda known by any thread. It
+// can only decrease. The accesses are atomic but not ordered with
+// respect to other memory accesses, which is enough for a bound.
+
+class ad_shared_lambda {
+public:
+
+    // Constructor:
+    ad_shared_lambda( double l )
+    {
+        val = l;
+    }
+
+    // Return the current value.
+    double get() const
+    {
+        double l;
+        __atomic_load( &val, &l, __ATOMIC_RELAXED );
+        return l;
+    }
+
+    // Set the value to l if l is smaller.
+    void lower( double l )
+    {
+        double cur = get();
+        while ( l < cur ) {
+            if ( __atomic_compare_exchange( &val, &cur, &l, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+                break;
+        }
+    }  // lower
+
+private:
+    double val;
+};  // ad_shared_lambda
+
+///////////////////////////////////////////////////////////////////////
+// Stop flag class: a flag that one thread sets to ask the others to
+// stop. The others check it now and then, so they stop soon after but
+// not at once.
+
+class ad_stop_flag {
+public:
+
+    // Constructor:
+    ad_stop_flag()
+    {
+        val = 0;
+    }
+
+    // Return true if the flag is set.
+    bool is_set() const
+    {
+        return __atomic_load_n( &val, __ATOMIC_RELAXED );
+    }
+
+    // Set the flag.
+    void set()
+    {
+        __atomic_store_n( &val, 1, __ATOMIC_RELAXED );
+    }
+
+private:
+    int val;
+};  // ad_stop_flag
+
+///////////////////////////////////////////////////////////////////////
+// Run func( arg ) on nthreads threads, one of which is the calling
+// thread, and return after all of them finish.
+inline
+void
+run_threads( int nthreads, void *( *func )( void * ), void *arg )
+{
+    pthread_t *tids = new pthread_t[ nthreads ];
+
+    for ( int i = 1; i < nthreads; ++i ) {
+        if ( pthread_create( &tids[ i ], NULL, func, arg ) ) {
+            printf( "ERROR: Cannot create thread %d.\n", i );
+            abort();
+        }
+    }
+
+    ( *func )( arg );
+
+    for ( int i = 1; i < nthreads; ++i )
+        pthread_join( tids[ i ], NULL );
+
+    delete [] tids;
+}  // run_threads
+
+#endif
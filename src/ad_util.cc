@@ -9,6 +9,12 @@
 // For log.
 #include <math.h>
 
+// For map_file().
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "ad_globals.h"
 #include "ad_util.h"
 
@@ -41,6 +47,9 @@ end_count()
 }
 #endif
 
+// The distribution to generate the edge weights with in modes 1 and 2.
+int ( *dist_func )( int, int );
+
 // Measure time.
 float 
 used_time()
@@ -56,6 +65,53 @@ used_time()
 #endif
 }
 
+// Map a file into memory.
+char *
+map_file( const char *file_name, size_t& size )
+{
+    size = 0;
+
+    int fd = open( file_name, O_RDONLY );
+    if ( -1 == fd ) {
+        printf( "ERROR: Cannot open the input file %s.\n", file_name );
+        return NULL;
+    }
+
+    struct stat st;
+    if ( -1 == fstat( fd, &st ) ) {
+        printf( "ERROR: Cannot stat the input file %s.\n", file_name );
+        close( fd );
+        return NULL;
+    }
+
+    // An empty file cannot be mapped.
+    if ( 0 == st.st_size ) {
+        printf( "ERROR: The input file %s is empty.\n", file_name );
+        close( fd );
+        return NULL;
+    }
+
+    void *data = mmap( NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( MAP_FAILED == data ) {
+        printf( "ERROR: Cannot map the input file %s.\n", file_name );
+        return NULL;
+    }
+    size = st.st_size;
+
+    // The file is read front to back.
+    madvise( data, size, MADV_SEQUENTIAL );
+
+    return ( char * ) data;
+}  // map_file
+
+void
+unmap_file( char *data, size_t size )
+{
+    if ( data )
+        munmap( data, size );
+}  // unmap_file
+
 // Initialize the random number generator.
 long
 randomize( long seed )
@@ -114,6 +170,8 @@ parse_args( int argc, char *argv[], args_t& args )
 
     // Format: [input_file] [-m 0/1/2] [-v 0/1] [-n nruns] [-o offset]
     // [-d 0/1/2] [-p n m] [-w w1 w2] [-t t1 t2] [-s seed] [-f dump_file]
+    // [-j nthreads] [-b 0/1/2] [-c 0/1/2] [-a alg1,alg2,...] [-r 0/1]
+    // [-x 0/1] [-i 0/16/32/64]
 
     args.mode = 0; // 0, 1, 2
     strcpy( args.input_file, "" );
@@ -129,6 +187,13 @@ parse_args( int argc, char *argv[], args_t& args )
     args.t1 = 1;
     args.t2 = 10;
     args.seed = -1;
+    args.nthreads = 0;  // One thread, with the serial version of Howard's.
+    args.bin_format = 0; // 0=DIMACS, 1=binary, 2=binary with adjacency
+    args.scc_alg = 0; // 0=two-pass (Kosaraju), 1=one-pass (Pearce), 2=parallel
+    strcpy( args.alg_names, "" ); // Empty for the default solver
+    args.race = false;
+    args.exact = false;
+    args.num_bits = 0; // 0=auto, 16, 32, 64
 
     int i = 1;
 
@@ -247,6 +312,85 @@ parse_args( int argc, char *argv[], args_t& args )
                 error_found = true;
             strcpy( args.dump_file, argv[ i + 1 ] );
             i += 2;
+        } else if ( !strcmp( argv[ i ], "-a" ) ) {
+            if ( 1 >= ( argc - i ) ) 
+                error_found = true;
+            strcpy( args.alg_names, argv[ i + 1 ] );
+            i += 2;
+        } else if ( !strcmp( argv[ i ], "-r" ) ) {
+            if ( 1 >= ( argc - i ) ) 
+                error_found = true;
+            int tmp = atoi( argv[ i + 1 ] );
+            switch ( tmp ) {
+            case 0: case 1: break;
+            default:
+                printf( "\nERROR: '-r' must be followed by 0 or 1.\n" );
+                error_found = true;
+            }
+            args.race = ( 1 == tmp );
+#ifdef REP_COUNT
+            // The counters are not thread-safe.
+            args.race = false;
+#endif
+            i += 2;
+        } else if ( !strcmp( argv[ i ], "-b" ) ) {
+            if ( 1 >= ( argc - i ) ) 
+                error_found = true;
+            args.bin_format = atoi( argv[ i + 1 ] );
+            switch ( args.bin_format ) {
+            case 0: case 1: case 2: break;
+            default:
+                printf( "\nERROR: '-b' must be followed by 0, 1, or 2.\n" );
+                error_found = true;
+            }
+            i += 2;
+        } else if ( !strcmp( argv[ i ], "-c" ) ) {
+            if ( 1 >= ( argc - i ) ) 
+                error_found = true;
+            args.scc_alg = atoi( argv[ i + 1 ] );
+            switch ( args.scc_alg ) {
+            case 0: case 1: case 2: break;
+            default:
+                printf( "\nERROR: '-c' must be followed by 0, 1, or 2.\n" );
+                error_found = true;
+            }
+            i += 2;
+        } else if ( !strcmp( argv[ i ], "-x" ) ) {
+            if ( 1 >= ( argc - i ) ) 
+                error_found = true;
+            int tmp = atoi( argv[ i + 1 ] );
+            switch ( tmp ) {
+            case 0: case 1: break;
+            default:
+                printf( "\nERROR: '-x' must be followed by 0 or 1.\n" );
+                error_found = true;
+            }
+            args.exact = ( 1 == tmp );
+            i += 2;
+        } else if ( !strcmp( argv[ i ], "-i" ) ) {
+            if ( 1 >= ( argc - i ) ) 
+                error_found = true;
+            args.num_bits = atoi( argv[ i + 1 ] );
+            switch ( args.num_bits ) {
+            case 0: case 16: case 32: case 64: break;
+            default:
+                printf( "\nERROR: '-i' must be followed by 0, 16, 32, or 64.\n" );
+                error_found = true;
+            }
+            i += 2;
+        } else if ( !strcmp( argv[ i ], "-j" ) ) {
+            if ( 1 >= ( argc - i ) ) 
+                error_found = true;
+            args.nthreads = atoi( argv[ i + 1 ] );
+            if ( args.nthreads <= 0 ) {
+                printf( "\nERROR: '-j' must be followed by a positive integer.\n" );
+                error_found = true;
+            }
+#ifdef REP_COUNT
+            // The counters are not thread-safe.
+            args.nthreads = 1;
+#endif
+            i += 2;
         } else {
             error_found = true;
             break;
@@ -282,6 +426,13 @@ parse_args( int argc, char *argv[], args_t& args )
         printf( "   [-t/time t1 t2]  min and max transit time bounds\n" );
         printf( "   [-s seed]        random number generator seed\n" );
         printf( "   [-f dump_file]   file to dump output\n" );
+        printf( "   [-j nthreads]    number of threads to find and solve the SCCs with\n" );
+        printf( "   [-b/inary 0/1/2] dump in DIMACS, binary, or binary with adjacency\n" );
+        printf( "   [-c/omp 0/1/2]   find SCCs in two DFS passes, one, or in parallel\n" );
+        printf( "   [-a/lg a1,a2]    algorithms to solve with, e.g., howard or ko,yto\n" );
+        printf( "   [-r/ace 0/1]     run the algorithms in turn or race them on each SCC\n" );
+        printf( "   [-x/act 0/1]     verify lambda with integer Bellman-Ford or not\n" );
+        printf( "   [-i/nt 0/16/32/64] bits of the solver numbers, 0 to fit each SCC\n" );
 
         printf( "\nBelow are what is known from parsing:\n" );
         printf( "\tmode= %d\n", args.mode );
@@ -311,6 +462,13 @@ parse_args( int argc, char *argv[], args_t& args )
         printf( "\t[t1:t2]= [ %d : %d ]\n", args.t1, args.t2 ); 
         printf( "\tseed= %ld\n", args.seed );
         printf( "\tdump file= %s\n", args.dump_file );
+        printf( "\tnum threads= %d\n", args.nthreads );
+        printf( "\tdump format= %d\n", args.bin_format );
+        printf( "\tscc alg= %d\n", args.scc_alg );
+        printf( "\talgorithms= %s\n", args.alg_names );
+        printf( "\trace= %d\n", args.race );
+        printf( "\texact= %d\n", args.exact );
+        printf( "\tnum bits= %d\n", args.num_bits );
 
         exit( 0 );
 
@@ -16,6 +16,15 @@ end_count();
 float 
 used_time();
 
+// Map the file file_name into memory and return its contents and size.
+// The mapping is private: the contents can be changed but the changes
+// are not written back to the file. Return NULL, after printing an
+// error, if the file is empty or cannot be mapped.
+char *
+map_file( const char *file_name, size_t& size );
+void
+unmap_file( char *data, size_t size );
+
 // Random number generation.
 long
 randomize( long seed );
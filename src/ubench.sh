@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# Benchmarking the SCC algorithms on a graph with 1M nodes and 500k
+# trivial SCCs: a cycle through nodes 1 to 500000, and an edge from
+# each of these nodes to a node of its own among nodes 500001 to
+# 1000000. The graph is written to a temporary file. Usage: ubench.sh
+# [executable], howard.x by default.
+
+x=${1:-howard.x}
+f=$(mktemp /tmp/ubench.XXXXXX)
+
+awk 'BEGIN {
+    n = 500000;
+    print "p bench", 2 * n, 2 * n;
+    for (i = 1; i <= n; ++i)
+        print "a", i, (i % n) + 1, 1 + (i % 300), 1 + (i % 10);
+    for (i = 1; i <= n; ++i)
+        print "a", i, n + i, 1 + (i % 300), 1 + (i % 10);
+}' > $f
+
+for c in 0 1 2;
+do
+   echo "-c $c:"
+   ./$x $f -c $c | grep -E "components|lambda"
+done
+
+rm -f $f
+
+# EOF
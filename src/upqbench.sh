@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Benchmarking the heaps of KO and YTO: each of kotrace.x and
+# ytotrace.x is run on a sparse and a dense random graph, recording
+# its heap operations, and pqbench.x replays them on each heap. Build
+# with 'make pqbench' first. Usage: upqbench.sh [nreps], 3 by default.
+
+r=${1:-3}
+f=$(mktemp /tmp/upqbench.XXXXXX)
+
+for x in ko yto;
+do
+   for g in "sparse 200000 600000" "dense 2000 400000";
+   do
+      set -- $g
+      echo "$x $1: n= $2 m= $3"
+      PQ_TRACE_FILE=$f ./${x}trace.x -p $2 $3 -s 1 | grep lambda
+      ./pqbench.x $f $r
+   done
+done
+
+rm -f $f
+
+# EOF
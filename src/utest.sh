@@ -6,10 +6,117 @@
 
 for i in *.x; 
 do 
+   # Skip the heap benchmark programs (see 'make bench_pq'), the
+   # library test, and the server (see below).
+   case $i in *trace.x|pqbench.x|libtest.x|ocrd.x) continue;; esac
    ./$i ../input/sample.d -v 1 | grep lambda | awk -v p=$i -v v=1 -v t=2.90 -v e=0.01 -f utest.awk 
    ./$i ../input/sample.d -v 0 | grep lambda | awk -v p=$i -v v=0 -v t=3.85 -v e=0.01 -f utest.awk 
 done
 
-# EOF
+# ocr.x runs every algorithm selected with -a.
+if [ -x ocr.x ];
+then
+   for a in burns howard ko lawler szymanski tarjan valiter yto;
+   do
+      ./ocr.x ../input/sample.d -v 1 -a $a | grep lambda | awk -v p="ocr.x -a $a" -v v=1 -v t=2.90 -v e=0.01 -f utest.awk 
+      ./ocr.x ../input/sample.d -v 0 -a $a | grep lambda | awk -v p="ocr.x -a $a" -v v=0 -v t=3.85 -v e=0.01 -f utest.awk 
+   done
+
+   # -x 1 verifies lambda in integers.
+   for a in howard yto;
+   do
+      ./ocr.x ../input/sample.d -v 1 -a $a -x 1 | grep lambda | awk -v p="ocr.x -a $a -x 1" -v v=1 -v t=2.90 -v e=0.01 -f utest.awk 
+      ./ocr.x ../input/sample.d -v 0 -a $a -x 1 | grep lambda | awk -v p="ocr.x -a $a -x 1" -v v=0 -v t=3.85 -v e=0.01 -f utest.awk 
+   done
+
+   # -i solves with 16-, 32-, or 64-bit numbers.
+   for i in 16 32 64;
+   do
+      for a in howard ko yto;
+      do
+         ./ocr.x ../input/sample.d -v 1 -a $a -i $i | grep lambda | awk -v p="ocr.x -a $a -i $i" -v v=1 -v t=2.90 -v e=0.01 -f utest.awk 
+         ./ocr.x ../input/sample.d -v 0 -a $a -i $i | grep lambda | awk -v p="ocr.x -a $a -i $i" -v v=0 -v t=3.85 -v e=0.01 -f utest.awk 
+      done
+   done
+
+   # '-t 1 1' generates all transit times as 1, which is solved as a
+   # cycle mean problem.
+   for a in burns howard ko lawler szymanski tarjan valiter yto;
+   do
+      ./ocr.x -m 2 -p 200 800 -t 1 1 -s 1 -v 1 -a $a -x 1 | grep lambda | awk -v p="ocr.x -a $a -t 1 1" -v v=1 -v t=20.00 -v e=0.001 -f utest.awk
+      ./ocr.x -m 2 -p 200 800 -t 1 1 -s 1 -v 0 -a $a -x 1 | grep lambda | awk -v p="ocr.x -a $a -t 1 1" -v v=0 -v t=258.13 -v e=0.001 -f utest.awk
+   done
+
+   # -j runs Howard's algorithm on the threads if there is one SCC.
+   for j in 2 4;
+   do
+      ./ocr.x -m 2 -p 20000 80000 -s 1 -v 1 -a howard -j $j -x 1 | grep lambda | awk -v p="ocr.x -a howard -j $j" -v v=1 -v t=4.90 -v e=0.001 -f utest.awk
+      ./ocr.x -m 2 -p 20000 80000 -s 1 -v 0 -a howard -j $j -x 1 | grep lambda | awk -v p="ocr.x -a howard -j $j" -v v=0 -v t=115.61 -v e=0.001 -f utest.awk
+   done
 
+   # The result of Howard's algorithm, lambda and the critical cycle,
+   # does not depend on the number of threads given with -j. The graph
+   # has many cycles with the same ratio, from which the serial version
+   # takes another one.
+   for v in 0 1;
+   do
+      r1=`./ocr.x -m 2 -p 5000 20000 -w 1 3 -t 1 3 -s 4 -v $v -a howard -j 1 | grep final | sed 's/time=.*//'`
+      for j in 2 4;
+      do
+         rj=`./ocr.x -m 2 -p 5000 20000 -w 1 3 -t 1 3 -s 4 -v $v -a howard -j $j | grep final | sed 's/time=.*//'`
+         if [ -n "$r1" ] && [ "$r1" = "$rj" ];
+         then
+            echo "Passed: program=ocr.x -a howard -j $j ver=$v same as -j 1"
+         else
+            echo "Failed: program=ocr.x -a howard -j $j ver=$v same as -j 1"
+         fi
+      done
+   done
 
+   # Weights up to INT_MAX are solved without loss of precision, and a
+   # weight above INT_MAX is rejected rather than wrapped around.
+   d=/tmp/utest.$$.d
+   printf "p sp 2 2\na 1 2 2147483647 1\na 2 1 2147483646 1\n" > $d
+   ./ocr.x $d -v 1 -a howard -i 64 | grep lambda | awk -v p="ocr.x -i 64 INT_MAX" -v v=1 -v t=2147483646.50 -v e=1e-10 -f utest.awk
+   printf "p sp 2 2\na 1 2 3000000000 1\na 2 1 1 1\n" > $d
+   if ./ocr.x $d -v 1 -a howard -i 64 | grep -q "ERROR: The weight of edge 1 is out of range";
+   then
+      echo "Passed: program=ocr.x weight above INT_MAX rejected"
+   else
+      echo "Failed: program=ocr.x weight above INT_MAX rejected"
+   fi
+   rm -f $d
+fi
+
+# libtest.x solves the same graph via the library, and checks the ratio
+# of the critical cycle it returns.
+if [ -x libtest.x ];
+then
+   for a in burns howard ko lawler szymanski tarjan valiter yto;
+   do
+      ./libtest.x -v 1 -a $a | grep lambda | awk -v p="libtest.x -a $a" -v v=1 -v t=2.90 -v e=0.01 -f utest.awk 
+      ./libtest.x -v 0 -a $a | grep lambda | awk -v p="libtest.x -a $a" -v v=0 -v t=3.85 -v e=0.01 -f utest.awk 
+   done
+   ./libtest.x -v 1 -x 1 | grep lambda | awk -v p="libtest.x -x 1" -v v=1 -v t=2.90 -v e=0.01 -f utest.awk 
+   ./libtest.x -v 0 -x 1 | grep lambda | awk -v p="libtest.x -x 1" -v v=0 -v t=3.85 -v e=0.01 -f utest.awk 
+fi
+
+# ocrd.x solves the same graph loaded once, as requested by a client.
+if [ -x ocrd.x ];
+then
+   s=/tmp/ocrd.$$.sock
+   ./ocrd.x $s &
+   while [ ! -S $s ]; do sleep 0.1; done
+   for a in burns howard ko lawler szymanski tarjan valiter yto;
+   do
+      echo "solve sample min $a" >> /tmp/ocrd.$$.req
+      echo "solve sample max $a" >> /tmp/ocrd.$$.req
+   done
+   ( echo "load sample ../input/sample.d"; cat /tmp/ocrd.$$.req; echo shutdown ) | ./ocrd.x -c $s > /tmp/ocrd.$$.out
+   wait
+   grep min_lambda /tmp/ocrd.$$.out | awk -v p="ocrd.x" -v v=1 -v t=2.90 -v e=0.01 -f utest.awk 
+   grep max_lambda /tmp/ocrd.$$.out | awk -v p="ocrd.x" -v v=0 -v t=3.85 -v e=0.01 -f utest.awk 
+   rm -f /tmp/ocrd.$$.req /tmp/ocrd.$$.out
+fi
+
+# EOF